@@ -0,0 +1,300 @@
+#include "particle_life.h"
+#include <algorithm>
+#include <array>
+#include <new>
+#include <type_traits>
+#include <variant>
+#include "Graphics/World.h"
+
+static_assert(sizeof(int) == sizeof(int32_t), "species are exposed as int32_t");
+static_assert(PL_MAX_SPECIES == World2D::MAX_SPECIES, "PL_MAX_SPECIES must match the engine");
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float) && sizeof(glm::vec3) == 3 * sizeof(float),
+              "views assume tightly packed vectors");
+
+struct pl_world {
+  std::variant<World2D, World3D> world;
+};
+
+namespace {
+
+// Runs fn on the typed world and turns any escaping exception into a status
+template <typename Fn> pl_status guarded(pl_world *world, Fn &&fn) {
+  if (world == nullptr) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  try {
+    return std::visit(fn, world->world);
+  } catch (const std::bad_alloc &) {
+    return PL_ERROR_OUT_OF_MEMORY;
+  } catch (...) {
+    return PL_ERROR_INTERNAL;
+  }
+}
+
+template <int D> glm::vec<D, float> loadVec(const float *values) {
+  glm::vec<D, float> v(0.0F);
+  if (values != nullptr) {
+    for (int d = 0; d < D; ++d) {
+      v[d] = values[d];
+    }
+  }
+  return v;
+}
+
+template <int D> bool validExtent(const float *extent) {
+  if (extent == nullptr) {
+    return false;
+  }
+  for (int d = 0; d < D; ++d) {
+    if (!(extent[d] > 0.0F)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename W> constexpr int dimensionsOf() { return W::Vec::length(); }
+
+} // namespace
+
+extern "C" {
+
+int pl_api_version(void) { return PL_API_VERSION; }
+
+pl_world *pl_world_create(int dimensions, const float *extent) {
+  try {
+    if (dimensions == 2 && validExtent<2>(extent)) {
+      auto *world = new pl_world{World2D()};
+      std::get<World2D>(world->world).setExtent(loadVec<2>(extent));
+      return world;
+    }
+    if (dimensions == 3 && validExtent<3>(extent)) {
+      auto *world = new pl_world{World3D()};
+      std::get<World3D>(world->world).setExtent(loadVec<3>(extent));
+      return world;
+    }
+  } catch (...) {
+  }
+  return nullptr;
+}
+
+void pl_world_destroy(pl_world *world) { delete world; }
+
+int pl_world_dimensions(const pl_world *world) {
+  if (world == nullptr) {
+    return 0;
+  }
+  return std::visit([](const auto &w) { return dimensionsOf<std::decay_t<decltype(w)>>(); },
+                    world->world);
+}
+
+pl_status pl_world_reserve(pl_world *world, size_t capacity) {
+  return guarded(world, [&](auto &w) {
+    w.reserve(capacity);
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_spawn(pl_world *world, const float *position, const float *velocity,
+                         int species, size_t *out_index) {
+  if (position == nullptr || species < 0 || species >= PL_MAX_SPECIES) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    constexpr int D = dimensionsOf<std::decay_t<decltype(w)>>();
+    const size_t index = w.spawn(loadVec<D>(position), loadVec<D>(velocity), species);
+    if (out_index != nullptr) {
+      *out_index = index;
+    }
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_spawn_many(pl_world *world, size_t count, const float *positions,
+                              const float *velocities, const int32_t *species) {
+  if (count > 0 && (positions == nullptr || species == nullptr)) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    constexpr int D = dimensionsOf<std::decay_t<decltype(w)>>();
+    for (size_t i = 0; i < count; ++i) {
+      if (species[i] < 0 || species[i] >= PL_MAX_SPECIES) {
+        return PL_ERROR_INVALID_ARGUMENT;
+      }
+    }
+    w.reserve(w.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+      w.spawn(loadVec<D>(positions + (i * D)),
+              loadVec<D>(velocities != nullptr ? velocities + (i * D) : nullptr), species[i]);
+    }
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_spawn_random(pl_world *world, size_t count, int species_count, uint32_t seed) {
+  if (species_count < 1 || species_count > PL_MAX_SPECIES) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    w.spawnRandom(count, species_count, seed);
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_remove(pl_world *world, size_t index) {
+  return guarded(world, [&](auto &w) {
+    if (index >= w.size()) {
+      return PL_ERROR_INVALID_ARGUMENT;
+    }
+    w.remove(index);
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_clear(pl_world *world) {
+  return guarded(world, [](auto &w) {
+    w.clear();
+    return PL_OK;
+  });
+}
+
+size_t pl_world_size(const pl_world *world) {
+  return world != nullptr ? std::visit([](const auto &w) { return w.size(); }, world->world) : 0;
+}
+
+pl_status pl_world_step(pl_world *world, float delta_time, uint64_t steps) {
+  if (!(delta_time >= 0.0F)) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    for (uint64_t s = 0; s < steps; ++s) {
+      w.step(delta_time);
+    }
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_get_params(const pl_world *world, pl_params *out_params) {
+  if (world == nullptr || out_params == nullptr) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  const WorldParams &params =
+      std::visit([](const auto &w) -> const WorldParams & { return w.getParams(); }, world->world);
+  *out_params = {params.rMax, params.friction, params.bounce, params.bounded ? 1 : 0};
+  return PL_OK;
+}
+
+pl_status pl_world_set_params(pl_world *world, const pl_params *params) {
+  if (params == nullptr || !(params->r_max > 0.0F) || params->friction < 0.0F ||
+      params->bounce < 0.0F) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    w.getParams() = {params->r_max, params->friction, params->bounce, params->bounded != 0};
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_set_extent(pl_world *world, const float *extent) {
+  return guarded(world, [&](auto &w) {
+    constexpr int D = dimensionsOf<std::decay_t<decltype(w)>>();
+    if (!validExtent<D>(extent)) {
+      return PL_ERROR_INVALID_ARGUMENT;
+    }
+    w.setExtent(loadVec<D>(extent));
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_set_matrix(pl_world *world, const float *values, int species_count) {
+  if (values == nullptr || species_count < 1 || species_count > PL_MAX_SPECIES) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  std::array<float, PL_MAX_SPECIES * PL_MAX_SPECIES> full{};
+  for (int a = 0; a < species_count; ++a) {
+    std::copy(values + (a * species_count), values + ((a + 1) * species_count),
+              full.begin() + (a * PL_MAX_SPECIES));
+  }
+  return guarded(world, [&](auto &w) {
+    w.setInteractionMatrix(full.data());
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_set_interaction(pl_world *world, int receiver, int source, float strength) {
+  if (receiver < 0 || receiver >= PL_MAX_SPECIES || source < 0 || source >= PL_MAX_SPECIES) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    w.setInteraction(receiver, source, strength);
+    return PL_OK;
+  });
+}
+
+float pl_world_get_interaction(const pl_world *world, int receiver, int source) {
+  if (world == nullptr) {
+    return 0.0F;
+  }
+  return std::visit([&](const auto &w) { return w.getInteraction(receiver, source); },
+                    world->world);
+}
+
+pl_status pl_world_randomize_interactions(pl_world *world, int species_count, uint32_t seed) {
+  if (species_count < 1 || species_count > PL_MAX_SPECIES) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    w.randomizeInteractions(species_count, seed);
+    return PL_OK;
+  });
+}
+
+pl_status pl_world_set_species_beta(pl_world *world, int species, float beta) {
+  if (species < 0 || species >= PL_MAX_SPECIES || !(beta > 0.0F && beta < 1.0F)) {
+    return PL_ERROR_INVALID_ARGUMENT;
+  }
+  return guarded(world, [&](auto &w) {
+    w.setSpeciesBeta(species, beta);
+    return PL_OK;
+  });
+}
+
+pl_float_view pl_world_positions(const pl_world *world) {
+  if (world == nullptr) {
+    return {nullptr, 0, 0, 0};
+  }
+  return std::visit(
+      [](const auto &w) {
+        constexpr int D = dimensionsOf<std::decay_t<decltype(w)>>();
+        return pl_float_view{reinterpret_cast<const float *>(w.getPositions()),
+                             sizeof(glm::vec<D, float>), w.size(), D};
+      },
+      world->world);
+}
+
+pl_float_view pl_world_velocities(const pl_world *world) {
+  if (world == nullptr) {
+    return {nullptr, 0, 0, 0};
+  }
+  return std::visit(
+      [](const auto &w) {
+        constexpr int D = dimensionsOf<std::decay_t<decltype(w)>>();
+        return pl_float_view{reinterpret_cast<const float *>(w.getVelocities()),
+                             sizeof(glm::vec<D, float>), w.size(), D};
+      },
+      world->world);
+}
+
+pl_int_view pl_world_species(const pl_world *world) {
+  if (world == nullptr) {
+    return {nullptr, 0, 0};
+  }
+  return std::visit(
+      [](const auto &w) {
+        return pl_int_view{reinterpret_cast<const int32_t *>(w.getSpecies()), sizeof(int32_t),
+                           w.size()};
+      },
+      world->world);
+}
+
+} // extern "C"
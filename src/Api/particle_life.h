@@ -0,0 +1,110 @@
+#pragma once
+
+/*
+ * Stable C interface to the particle life engine, for embedding and FFI bindings.
+ *
+ * A world is a box centred on the origin in 2 or 3 dimensions. Particles are dense: indices run
+ * from 0 to size - 1 and removing one moves the last particle into its slot.
+ *
+ * Array views point straight into the engine's storage. They stay valid across steps and
+ * parameter changes, and are invalidated by anything that changes the particle count (spawn,
+ * remove, clear, reserve) or by destroying the world. Views are read-only.
+ *
+ * No function throws or aborts; errors are reported through pl_status. A world must not be used
+ * from two threads at once, but separate worlds are independent. Stepping itself runs in
+ * parallel with OpenMP.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(PL_BUILDING_LIBRARY)
+#define PL_API __declspec(dllexport)
+#else
+#define PL_API __declspec(dllimport)
+#endif
+#else
+#define PL_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PL_API_VERSION 1
+#define PL_MAX_SPECIES 16
+
+typedef enum pl_status {
+  PL_OK = 0,
+  PL_ERROR_INVALID_ARGUMENT = 1,
+  PL_ERROR_OUT_OF_MEMORY = 2,
+  PL_ERROR_INTERNAL = 3
+} pl_status;
+
+typedef struct pl_world pl_world;
+
+typedef struct pl_params {
+  float r_max;    /* interaction radius */
+  float friction; /* share of velocity kept per step */
+  float bounce;   /* speed kept when reflecting off the box */
+  int bounded;    /* nonzero to reflect particles off the box walls */
+} pl_params;
+
+/* count elements of components floats each; element i starts at data + i * stride bytes */
+typedef struct pl_float_view {
+  const float *data;
+  size_t stride;
+  size_t count;
+  int components;
+} pl_float_view;
+
+typedef struct pl_int_view {
+  const int32_t *data;
+  size_t stride;
+  size_t count;
+} pl_int_view;
+
+PL_API int pl_api_version(void);
+
+/* dimensions is 2 or 3; extent holds that many box sizes. Returns NULL on failure. */
+PL_API pl_world *pl_world_create(int dimensions, const float *extent);
+PL_API void pl_world_destroy(pl_world *world);
+PL_API int pl_world_dimensions(const pl_world *world);
+
+PL_API pl_status pl_world_reserve(pl_world *world, size_t capacity);
+/* position and velocity hold dimensions floats; velocity may be NULL for rest */
+PL_API pl_status pl_world_spawn(pl_world *world, const float *position, const float *velocity,
+                                int species, size_t *out_index);
+/* Packed arrays of count * dimensions floats and count species; velocities may be NULL */
+PL_API pl_status pl_world_spawn_many(pl_world *world, size_t count, const float *positions,
+                                     const float *velocities, const int32_t *species);
+PL_API pl_status pl_world_spawn_random(pl_world *world, size_t count, int species_count,
+                                       uint32_t seed);
+PL_API pl_status pl_world_remove(pl_world *world, size_t index);
+PL_API pl_status pl_world_clear(pl_world *world);
+PL_API size_t pl_world_size(const pl_world *world);
+
+PL_API pl_status pl_world_step(pl_world *world, float delta_time, uint64_t steps);
+
+PL_API pl_status pl_world_get_params(const pl_world *world, pl_params *out_params);
+PL_API pl_status pl_world_set_params(pl_world *world, const pl_params *params);
+PL_API pl_status pl_world_set_extent(pl_world *world, const float *extent);
+
+/* Row-major species_count x species_count matrix; row = receiving species. Unlisted pairs are
+ * set to zero. */
+PL_API pl_status pl_world_set_matrix(pl_world *world, const float *values, int species_count);
+PL_API pl_status pl_world_set_interaction(pl_world *world, int receiver, int source,
+                                          float strength);
+PL_API float pl_world_get_interaction(const pl_world *world, int receiver, int source);
+PL_API pl_status pl_world_randomize_interactions(pl_world *world, int species_count,
+                                                 uint32_t seed);
+PL_API pl_status pl_world_set_species_beta(pl_world *world, int species, float beta);
+
+PL_API pl_float_view pl_world_positions(const pl_world *world);
+PL_API pl_float_view pl_world_velocities(const pl_world *world);
+PL_API pl_int_view pl_world_species(const pl_world *world);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,349 @@
+#include "DistributedWorld.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace {
+
+// Wire format of one particle. Ranks are assumed to share endianness and float layout.
+struct ParticleRecord {
+  glm::vec2 pos;
+  glm::vec2 vel;
+  int32_t species;
+};
+
+float millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() -
+                                                  start)
+      .count();
+}
+
+} // namespace
+
+DistributedWorld::DistributedWorld(Transport &transport, const glm::vec2 &extent,
+                                   const WorldParams &params)
+    : transport(transport), extent(extent) {
+  world.setExtent(extent);
+  world.getParams() = params;
+  partitionSlabs();
+}
+
+void DistributedWorld::partitionSlabs() {
+  const int n = transport.size();
+  const glm::vec2 origin = -extent * 0.5F;
+  domains.resize(n);
+  const float width = extent.x / static_cast<float>(n);
+  for (int r = 0; r < n; ++r) {
+    const float right = r == n - 1 ? extent.x : width * static_cast<float>(r + 1);
+    domains[r].lo = {origin.x + (width * static_cast<float>(r)), origin.y};
+    domains[r].hi = {origin.x + right, origin.y + extent.y};
+  }
+  updateGridRegion();
+}
+
+void DistributedWorld::updateGridRegion() {
+  // Owned particles and their ghosts all lie within R_MAX of the own domain
+  const Domain &own = domains[transport.rank()];
+  const float margin = world.getParams().rMax;
+  world.setGridRegion(own.lo - margin, (own.hi - own.lo) + (2.0F * margin));
+}
+
+void DistributedWorld::seedRandom(size_t totalCount, int speciesCount, uint32_t seed) {
+  world.clear();
+  world.randomizeInteractions(speciesCount, seed);
+
+  // All ranks walk the same sequence and keep their own share, so the union is one layout
+  std::mt19937 gen(seed + 1);
+  std::uniform_real_distribution<float> unit(-0.5F, 0.5F);
+  const int types = std::clamp(speciesCount, 1, World2D::MAX_SPECIES);
+  std::uniform_int_distribution<int> pick(0, types - 1);
+  const Domain &own = domains[transport.rank()];
+
+  for (size_t n = 0; n < totalCount; ++n) {
+    const glm::vec2 pos(unit(gen) * extent.x, unit(gen) * extent.y);
+    const int type = pick(gen);
+    if (own.contains(pos)) {
+      world.spawn(pos, glm::vec2(0.0F), type);
+    }
+  }
+}
+
+int DistributedWorld::ownerOf(const glm::vec2 &pos) const {
+  int nearest = 0;
+  float nearestDist = std::numeric_limits<float>::max();
+  for (int r = 0; r < static_cast<int>(domains.size()); ++r) {
+    if (domains[r].contains(pos)) {
+      return r;
+    }
+    // Points on the far edge of the box belong to no half-open domain; take the closest one
+    const glm::vec2 clamped = glm::clamp(pos, domains[r].lo, domains[r].hi);
+    const float dist = glm::dot(pos - clamped, pos - clamped);
+    if (dist < nearestDist) {
+      nearestDist = dist;
+      nearest = r;
+    }
+  }
+  return nearest;
+}
+
+void DistributedWorld::pack(size_t index, Buffer &buffer) const {
+  const ParticleRecord record{world.getPositions()[index], world.getVelocities()[index],
+                              world.getSpecies()[index]};
+  const size_t offset = buffer.size();
+  buffer.resize(offset + sizeof(record));
+  std::memcpy(buffer.data() + offset, &record, sizeof(record));
+}
+
+size_t DistributedWorld::unpack(const Buffer &buffer) {
+  const size_t count = buffer.size() / sizeof(ParticleRecord);
+  for (size_t i = 0; i < count; ++i) {
+    ParticleRecord record{};
+    std::memcpy(&record, buffer.data() + (i * sizeof(record)), sizeof(record));
+    world.spawn(record.pos, record.vel, record.species);
+  }
+  return count;
+}
+
+size_t DistributedWorld::migrate() {
+  const int self = transport.rank();
+  outgoing.assign(transport.size(), {});
+
+  // Walk backwards so the particle swapped into a removed slot has already been looked at
+  size_t sent = 0;
+  for (size_t i = world.size(); i-- > 0;) {
+    const int owner = ownerOf(world.getPositions()[i]);
+    if (owner != self) {
+      pack(i, outgoing[owner]);
+      world.remove(i);
+      ++sent;
+    }
+  }
+
+  transport.allToAll(outgoing, incoming);
+  for (int r = 0; r < transport.size(); ++r) {
+    if (r != self) {
+      unpack(incoming[r]);
+    }
+  }
+  return sent;
+}
+
+size_t DistributedWorld::exchangeHalo() {
+  const int self = transport.rank();
+  const float margin = world.getParams().rMax;
+  const size_t owned = world.size();
+  outgoing.assign(transport.size(), {});
+
+  for (size_t i = 0; i < owned; ++i) {
+    const glm::vec2 pos = world.getPositions()[i];
+    for (int r = 0; r < transport.size(); ++r) {
+      if (r != self && domains[r].contains(pos, margin)) {
+        pack(i, outgoing[r]);
+      }
+    }
+  }
+
+  transport.allToAll(outgoing, incoming);
+  size_t ghosts = 0;
+  for (int r = 0; r < transport.size(); ++r) {
+    if (r != self) {
+      ghosts += unpack(incoming[r]);
+    }
+  }
+  return ghosts;
+}
+
+void DistributedWorld::step(float deltaTime) {
+  const auto start = std::chrono::high_resolution_clock::now();
+
+  timing.migrated = static_cast<uint32_t>(migrate());
+  const size_t owned = world.size();
+  timing.halo = static_cast<uint32_t>(exchangeHalo());
+  timing.owned = static_cast<uint32_t>(owned);
+  timing.commMs = millisecondsSince(start);
+
+  const auto computeStart = std::chrono::high_resolution_clock::now();
+  world.computeForces(owned);
+  world.integrate(deltaTime, owned);
+  timing.computeMs = millisecondsSince(computeStart);
+
+  ++stepCount;
+  windowComputeMs += timing.computeMs;
+  const bool check = rebalance.enabled && transport.size() > 1 && rebalance.checkEvery > 0 &&
+                     stepCount % rebalance.checkEvery == 0;
+  float averageMs = 0.0F;
+  if (check) {
+    averageMs = windowComputeMs / static_cast<float>(rebalance.checkEvery);
+    windowComputeMs = 0.0F;
+    measureCost(owned, averageMs);
+  }
+  world.truncate(owned);
+  timing.stepMs = millisecondsSince(start);
+
+  if (check && gatherImbalance(averageMs) > rebalance.threshold) {
+    repartition();
+  }
+}
+
+float DistributedWorld::gatherImbalance(float computeMs) {
+  Buffer local(sizeof(float));
+  std::memcpy(local.data(), &computeMs, sizeof(float));
+  std::vector<Buffer> all;
+  transport.allGather(local, all);
+
+  float maxMs = 0.0F;
+  float total = 0.0F;
+  for (const Buffer &buffer : all) {
+    float value = 0.0F;
+    std::memcpy(&value, buffer.data(), sizeof(float));
+    maxMs = std::max(maxMs, value);
+    total += value;
+  }
+  return total > 0.0F ? maxMs * static_cast<float>(all.size()) / total : 1.0F;
+}
+
+void DistributedWorld::measureCost(size_t owned, float computeMs) {
+  // The force pass visits the 3x3 block around each particle's cell, so a particle's work is
+  // the number of candidates in that block. The grid still holds the binning of this step.
+  const int res = std::max(rebalance.costResolution, 1);
+  cost.assign(static_cast<size_t>(res) * res, 0.0F);
+  const SpatialGrid &grid = world.getGrid();
+  const glm::vec2 origin = -extent * 0.5F;
+  const glm::vec2 toCost = glm::vec2(static_cast<float>(res)) / extent;
+
+  double pairs = 0.0;
+  for (int cell = 0; cell < grid.getCellCount(); ++cell) {
+    size_t ownedHere = 0;
+    for (size_t i : grid.getCell(cell)) {
+      ownedHere += i < owned ? 1 : 0;
+    }
+    if (ownedHere == 0) {
+      continue;
+    }
+
+    size_t candidates = 0;
+    grid.forEachNeighbourCell(cell, [&](int n) { candidates += grid.getCell(n).size(); });
+    const glm::ivec2 c =
+        glm::clamp(glm::ivec2((grid.getCellCenter(cell) - origin) * toCost), 0, res - 1);
+    const auto work = static_cast<float>(ownedHere * candidates);
+    cost[(static_cast<size_t>(c.y) * res) + c.x] += work;
+    pairs += work;
+  }
+
+  // Convert pair counts to this rank's measured milliseconds, so a slow host looks costly
+  if (pairs > 0.0) {
+    const auto scale = static_cast<float>(computeMs / pairs);
+    for (float &value : cost) {
+      value *= scale;
+    }
+  }
+}
+
+void DistributedWorld::repartition() {
+  const int res = std::max(rebalance.costResolution, 1);
+  if (cost.size() != static_cast<size_t>(res) * res) {
+    cost.assign(static_cast<size_t>(res) * res, 0.0F);
+  }
+
+  Buffer local(cost.size() * sizeof(float));
+  std::memcpy(local.data(), cost.data(), local.size());
+  std::vector<Buffer> all;
+  transport.allGather(local, all);
+
+  std::fill(cost.begin(), cost.end(), 0.0F);
+  std::vector<float> contribution(cost.size());
+  for (const Buffer &buffer : all) {
+    std::memcpy(contribution.data(), buffer.data(), std::min(buffer.size(), local.size()));
+    for (size_t i = 0; i < cost.size(); ++i) {
+      cost[i] += contribution[i];
+    }
+  }
+
+  bisect(0, transport.size(), glm::ivec2(0), glm::ivec2(res));
+  updateGridRegion();
+  ++repartitions;
+}
+
+void DistributedWorld::bisect(int firstRank, int rankCount, glm::ivec2 lo, glm::ivec2 hi) {
+  const int res = std::max(rebalance.costResolution, 1);
+  const glm::vec2 origin = -extent * 0.5F;
+  const glm::vec2 cellSize = extent / static_cast<float>(res);
+
+  const glm::ivec2 size = hi - lo;
+  if (rankCount == 1 || (size.x <= 1 && size.y <= 1)) {
+    // Leftover ranks of an unsplittable region get an empty domain at its far corner
+    for (int r = firstRank; r < firstRank + rankCount; ++r) {
+      const glm::ivec2 from = r == firstRank ? lo : hi;
+      domains[r].lo = origin + (glm::vec2(from) * cellSize);
+      domains[r].hi = origin + (glm::vec2(hi) * cellSize);
+    }
+    return;
+  }
+
+  // Cut the longer side in world units, unless it is a single cell wide
+  const glm::vec2 span = glm::vec2(size) * cellSize;
+  const int axis = (span.x >= span.y && size.x > 1) || size.y <= 1 ? 0 : 1;
+  const int other = 1 - axis;
+
+  std::vector<float> profile(size[axis], 0.0F);
+  for (int a = 0; a < size[axis]; ++a) {
+    for (int b = lo[other]; b < hi[other]; ++b) {
+      glm::ivec2 cell;
+      cell[axis] = lo[axis] + a;
+      cell[other] = b;
+      profile[a] += cost[(static_cast<size_t>(cell.y) * res) + cell.x];
+    }
+  }
+
+  const int leftRanks = rankCount / 2;
+  float total = 0.0F;
+  for (float value : profile) {
+    total += value;
+  }
+  const float target = total * static_cast<float>(leftRanks) / static_cast<float>(rankCount);
+
+  // With no measured cost anywhere, split by area instead
+  int cut = lo[axis] + std::max(1, (size[axis] * leftRanks) / rankCount);
+  if (total > 0.0F) {
+    float prefix = 0.0F;
+    float bestError = std::numeric_limits<float>::max();
+    for (int a = 1; a < size[axis]; ++a) {
+      prefix += profile[a - 1];
+      const float error = std::abs(prefix - target);
+      if (error < bestError) {
+        bestError = error;
+        cut = lo[axis] + a;
+      }
+    }
+  }
+
+  glm::ivec2 leftHi = hi;
+  glm::ivec2 rightLo = lo;
+  leftHi[axis] = cut;
+  rightLo[axis] = cut;
+  bisect(firstRank, leftRanks, lo, leftHi);
+  bisect(firstRank + leftRanks, rankCount - leftRanks, rightLo, hi);
+}
+
+ImbalanceReport DistributedWorld::gatherTimings() {
+  Buffer local(sizeof(RankTiming));
+  std::memcpy(local.data(), &timing, sizeof(RankTiming));
+  std::vector<Buffer> all;
+  transport.allGather(local, all);
+
+  ImbalanceReport report;
+  report.ranks.resize(all.size());
+  float total = 0.0F;
+  for (size_t r = 0; r < all.size(); ++r) {
+    std::memcpy(&report.ranks[r], all[r].data(), sizeof(RankTiming));
+    report.maxComputeMs = std::max(report.maxComputeMs, report.ranks[r].computeMs);
+    total += report.ranks[r].computeMs;
+  }
+  report.meanComputeMs = total / static_cast<float>(std::max<size_t>(all.size(), 1));
+  report.imbalance =
+      report.meanComputeMs > 0.0F ? report.maxComputeMs / report.meanComputeMs : 1.0F;
+  return report;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Distributed/Transport.h"
+#include "Graphics/World.h"
+
+// Axis-aligned region of the box owned by one rank; lo inclusive, hi exclusive
+struct Domain {
+  glm::vec2 lo{0.0F};
+  glm::vec2 hi{0.0F};
+
+  [[nodiscard]] bool contains(const glm::vec2 &p, float margin = 0.0F) const {
+    return p.x >= lo.x - margin && p.x < hi.x + margin && p.y >= lo.y - margin &&
+           p.y < hi.y + margin;
+  }
+};
+
+struct RankTiming {
+  float stepMs = 0.0F;
+  float computeMs = 0.0F; // forces and integration
+  float commMs = 0.0F;    // migration and halo exchange, including waiting on peers
+  uint32_t owned = 0;
+  uint32_t halo = 0;
+  uint32_t migrated = 0; // particles sent away this step
+};
+
+// Automatic cost-based repartitioning. Every checkEvery steps the ranks compare their compute
+// time averaged over those steps and, past the threshold, recut the box so each domain carries
+// the same measured cost.
+struct RebalanceSettings {
+  bool enabled = true;
+  float threshold = 1.15F;  // max over mean compute time that triggers a recut
+  int checkEvery = 20;      // steps between imbalance checks
+  int costResolution = 128; // cost map cells per axis
+};
+
+struct ImbalanceReport {
+  std::vector<RankTiming> ranks;
+  float maxComputeMs = 0.0F;
+  float meanComputeMs = 0.0F;
+  float imbalance = 1.0F; // slowest rank over the mean; 1 is perfectly balanced
+};
+
+// One rank's share of a particle life run split across processes. Each rank owns the particles
+// inside its domain and steps them with its own World2D. A step first migrates particles that
+// left the domain to their new owner, then copies every particle within R_MAX of another
+// domain there as a ghost, so forces near the cut see the same neighbours as a single box
+// would. Ghosts are sources only: they are appended after the owned particles, excluded from
+// integration and dropped again once forces are done.
+//
+// Domains start as slabs and are recut by recursive coordinate bisection of a global cost map
+// when the ranks drift out of balance. Each rank spreads its measured compute time over the
+// cost cells in proportion to the neighbour pairs its particles examined there; the summed map
+// is identical everywhere, so every rank derives the same cuts without further messages. Only
+// particles whose owner changed move, through the ordinary migration of the next step.
+class DistributedWorld {
+public:
+  DistributedWorld(Transport &transport, const glm::vec2 &extent, const WorldParams &params);
+
+  // Equal-width vertical slabs, one per rank
+  void partitionSlabs();
+  // Every rank must pass the same arguments: each spawns the particles that fall in its domain
+  // and all of them draw the same interaction matrix
+  void seedRandom(size_t totalCount, int speciesCount, uint32_t seed);
+
+  void step(float deltaTime);
+  // Collective: recuts the domains from the measured cost of the last check
+  void repartition();
+
+  [[nodiscard]] RebalanceSettings &getRebalanceSettings() { return rebalance; }
+  [[nodiscard]] int getRepartitionCount() const { return repartitions; }
+
+  // Collective: every rank must call it. All ranks receive the full report.
+  [[nodiscard]] ImbalanceReport gatherTimings();
+
+  [[nodiscard]] World2D &getWorld() { return world; }
+  [[nodiscard]] const std::vector<Domain> &getDomains() const { return domains; }
+  [[nodiscard]] const RankTiming &getTiming() const { return timing; }
+  [[nodiscard]] int getRank() const { return transport.rank(); }
+
+private:
+  Transport &transport;
+  World2D world;
+  glm::vec2 extent;
+  std::vector<Domain> domains;
+  RankTiming timing;
+  RebalanceSettings rebalance;
+  int stepCount = 0;
+  int repartitions = 0;
+  float windowComputeMs = 0.0F; // compute time summed since the last check
+  std::vector<float> cost;
+  std::vector<Buffer> outgoing;
+  std::vector<Buffer> incoming;
+
+  [[nodiscard]] int ownerOf(const glm::vec2 &pos) const;
+  void measureCost(size_t owned, float computeMs);
+  [[nodiscard]] float gatherImbalance(float computeMs);
+  void bisect(int firstRank, int rankCount, glm::ivec2 lo, glm::ivec2 hi);
+  void updateGridRegion();
+  size_t migrate();
+  size_t exchangeHalo();
+  void pack(size_t index, Buffer &buffer) const;
+  size_t unpack(const Buffer &buffer);
+};
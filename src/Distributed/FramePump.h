@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstring>
+#include "Distributed/Transport.h"
+
+// Drives one framed exchange over a byte stream: an 8-byte length, then the payload, in both
+// directions at once. write and read move what they can without blocking and return the byte
+// count; wait is called whenever neither made progress and is told if bytes remain to send.
+template <typename WriteFn, typename ReadFn, typename WaitFn>
+void pumpFrames(const Buffer &out, Buffer &in, WriteFn &&write, ReadFn &&read, WaitFn &&wait) {
+  const uint64_t outLength = out.size();
+  const size_t sendTotal = sizeof(outLength) + out.size();
+  size_t sent = 0;
+
+  uint64_t inLength = 0;
+  size_t headerRead = 0;
+  size_t received = 0;
+  bool haveHeader = false;
+
+  while (sent < sendTotal || !haveHeader || received < inLength) {
+    size_t progress = 0;
+
+    if (sent < sendTotal) {
+      const size_t n = sent < sizeof(outLength)
+                           ? write(reinterpret_cast<const uint8_t *>(&outLength) + sent,
+                                   sizeof(outLength) - sent)
+                           : write(out.data() + (sent - sizeof(outLength)), sendTotal - sent);
+      sent += n;
+      progress += n;
+    }
+
+    if (!haveHeader) {
+      const size_t n =
+          read(reinterpret_cast<uint8_t *>(&inLength) + headerRead, sizeof(inLength) - headerRead);
+      headerRead += n;
+      progress += n;
+      if (headerRead == sizeof(inLength)) {
+        haveHeader = true;
+        in.resize(inLength);
+      }
+    } else if (received < inLength) {
+      const size_t n = read(in.data() + received, inLength - received);
+      received += n;
+      progress += n;
+    }
+
+    if (progress == 0) {
+      wait(sent < sendTotal);
+    }
+  }
+}
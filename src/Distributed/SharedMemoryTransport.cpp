@@ -0,0 +1,132 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "Distributed/FramePump.h"
+#include "Distributed/Transport.h"
+
+namespace {
+
+constexpr size_t RING_BYTES = size_t(1) << 22;
+
+// Single-producer single-consumer byte ring living in the shared segment. The counters only
+// grow; a fresh segment is zero filled, which is exactly an empty ring.
+struct RingHeader {
+  alignas(64) uint64_t head; // bytes written, touched by the producer only
+  alignas(64) uint64_t tail; // bytes read, touched by the consumer only
+};
+
+constexpr size_t RING_STRIDE = sizeof(RingHeader) + RING_BYTES;
+
+class Ring {
+public:
+  explicit Ring(uint8_t *base)
+      : header(reinterpret_cast<RingHeader *>(base)), data(base + sizeof(RingHeader)) {}
+
+  size_t write(const uint8_t *src, size_t length) {
+    const uint64_t head = std::atomic_ref<uint64_t>(header->head).load(std::memory_order_relaxed);
+    const uint64_t tail = std::atomic_ref<uint64_t>(header->tail).load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(length, RING_BYTES - (head - tail));
+    copy(data, head, src, n, true);
+    std::atomic_ref<uint64_t>(header->head).store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  size_t read(uint8_t *dst, size_t length) {
+    const uint64_t tail = std::atomic_ref<uint64_t>(header->tail).load(std::memory_order_relaxed);
+    const uint64_t head = std::atomic_ref<uint64_t>(header->head).load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(length, head - tail);
+    copy(data, tail, dst, n, false);
+    std::atomic_ref<uint64_t>(header->tail).store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+private:
+  RingHeader *header;
+  uint8_t *data;
+
+  // Copies n bytes between a linear buffer and the ring starting at a stream position
+  static void copy(uint8_t *ring, uint64_t position, const void *linear, size_t n, bool toRing) {
+    const size_t offset = position % RING_BYTES;
+    const size_t first = std::min(n, RING_BYTES - offset);
+    auto *bytes = static_cast<uint8_t *>(const_cast<void *>(linear));
+    if (toRing) {
+      std::memcpy(ring + offset, bytes, first);
+      std::memcpy(ring, bytes + first, n - first);
+    } else {
+      std::memcpy(bytes, ring + offset, first);
+      std::memcpy(bytes + first, ring, n - first);
+    }
+  }
+};
+
+class SharedMemoryTransport : public Transport {
+public:
+  SharedMemoryTransport(std::string segmentName, int rankIndex, int rankCount)
+      : name(std::move(segmentName)), self(rankIndex), count(rankCount),
+        bytes(static_cast<size_t>(rankCount) * rankCount * RING_STRIDE) {
+    if (name.empty() || name[0] != '/') {
+      name.insert(name.begin(), '/');
+    }
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open shared memory segment " + name);
+    }
+    // Every rank sizes the segment; growing an already sized segment to the same length is a no-op
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      close(fd);
+      throw std::runtime_error("Failed to size shared memory segment " + name);
+    }
+    void *mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      throw std::runtime_error("Failed to map shared memory segment " + name);
+    }
+    base = static_cast<uint8_t *>(mapped);
+  }
+
+  ~SharedMemoryTransport() override {
+    munmap(base, bytes);
+    if (self == 0) {
+      shm_unlink(name.c_str());
+    }
+  }
+
+  SharedMemoryTransport(const SharedMemoryTransport &) = delete;
+  SharedMemoryTransport &operator=(const SharedMemoryTransport &) = delete;
+
+  [[nodiscard]] int rank() const override { return self; }
+  [[nodiscard]] int size() const override { return count; }
+
+  void exchange(int peer, const Buffer &out, Buffer &in) override {
+    Ring tx = ring(self, peer);
+    Ring rx = ring(peer, self);
+    pumpFrames(
+        out, in, [&](const uint8_t *src, size_t n) { return tx.write(src, n); },
+        [&](uint8_t *dst, size_t n) { return rx.read(dst, n); },
+        [](bool) { std::this_thread::yield(); });
+  }
+
+private:
+  std::string name;
+  int self;
+  int count;
+  size_t bytes;
+  uint8_t *base = nullptr;
+
+  [[nodiscard]] Ring ring(int from, int to) const {
+    return Ring(base + (static_cast<size_t>((from * count) + to) * RING_STRIDE));
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Transport> createSharedMemoryTransport(const std::string &name, int rank,
+                                                       int size) {
+  return std::make_unique<SharedMemoryTransport>(name, rank, size);
+}
@@ -0,0 +1,215 @@
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include "Distributed/FramePump.h"
+#include "Distributed/Transport.h"
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+constexpr int CONNECT_ATTEMPTS = 300;
+constexpr auto CONNECT_RETRY = std::chrono::milliseconds(100);
+
+struct Endpoint {
+  std::string host;
+  std::string port;
+};
+
+Endpoint parseEndpoint(const std::string &text) {
+  const size_t colon = text.rfind(':');
+  if (colon == std::string::npos) {
+    throw std::runtime_error("Endpoint must be host:port, got " + text);
+  }
+  return {text.substr(0, colon), text.substr(colon + 1)};
+}
+
+void configureSocket(int fd) {
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+void sendAll(int fd, const void *data, size_t length) {
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  while (length > 0) {
+    const ssize_t n = ::send(fd, bytes, length, SEND_FLAGS);
+    if (n <= 0) {
+      throw std::runtime_error("Socket handshake send failed");
+    }
+    bytes += n;
+    length -= static_cast<size_t>(n);
+  }
+}
+
+void recvAll(int fd, void *data, size_t length) {
+  auto *bytes = static_cast<uint8_t *>(data);
+  while (length > 0) {
+    const ssize_t n = ::recv(fd, bytes, length, 0);
+    if (n <= 0) {
+      throw std::runtime_error("Socket handshake receive failed");
+    }
+    bytes += n;
+    length -= static_cast<size_t>(n);
+  }
+}
+
+int listenOn(const std::string &port) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo *info = nullptr;
+  if (getaddrinfo(nullptr, port.c_str(), &hints, &info) != 0) {
+    throw std::runtime_error("Cannot resolve listen port " + port);
+  }
+
+  const int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+  const int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  const bool ok = fd >= 0 && bind(fd, info->ai_addr, info->ai_addrlen) == 0 && listen(fd, 64) == 0;
+  freeaddrinfo(info);
+  if (!ok) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::runtime_error("Cannot listen on port " + port);
+  }
+  return fd;
+}
+
+// Lower ranks may still be starting up, so refused connections are retried for a while
+int connectTo(const Endpoint &endpoint) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  for (int attempt = 0; attempt < CONNECT_ATTEMPTS; ++attempt) {
+    addrinfo *info = nullptr;
+    if (getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &info) == 0) {
+      const int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      const bool ok = fd >= 0 && connect(fd, info->ai_addr, info->ai_addrlen) == 0;
+      freeaddrinfo(info);
+      if (ok) {
+        return fd;
+      }
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+    std::this_thread::sleep_for(CONNECT_RETRY);
+  }
+  throw std::runtime_error("Cannot connect to " + endpoint.host + ":" + endpoint.port);
+}
+
+class SocketTransport : public Transport {
+public:
+  SocketTransport(const std::vector<std::string> &endpoints, int rankIndex)
+      : self(rankIndex), count(static_cast<int>(endpoints.size())), peers(endpoints.size(), -1) {
+    if (self < 0 || self >= count) {
+      throw std::runtime_error("Rank is outside the endpoint list");
+    }
+
+    const int listener = listenOn(parseEndpoint(endpoints[self]).port);
+
+    for (int peer = 0; peer < self; ++peer) {
+      const int fd = connectTo(parseEndpoint(endpoints[peer]));
+      const int32_t id = self;
+      sendAll(fd, &id, sizeof(id));
+      peers[peer] = fd;
+    }
+
+    for (int accepted = self + 1; accepted < count; ++accepted) {
+      const int fd = accept(listener, nullptr, nullptr);
+      if (fd < 0) {
+        close(listener);
+        throw std::runtime_error("Accepting a peer connection failed");
+      }
+      int32_t id = -1;
+      recvAll(fd, &id, sizeof(id));
+      if (id <= self || id >= count || peers[id] >= 0) {
+        close(fd);
+        close(listener);
+        throw std::runtime_error("Unexpected peer rank in handshake");
+      }
+      peers[id] = fd;
+    }
+    close(listener);
+
+    for (int fd : peers) {
+      if (fd >= 0) {
+        configureSocket(fd);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+      }
+    }
+  }
+
+  ~SocketTransport() override {
+    for (int fd : peers) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  SocketTransport(const SocketTransport &) = delete;
+  SocketTransport &operator=(const SocketTransport &) = delete;
+
+  [[nodiscard]] int rank() const override { return self; }
+  [[nodiscard]] int size() const override { return count; }
+
+  void exchange(int peer, const Buffer &out, Buffer &in) override {
+    const int fd = peers[peer];
+    pumpFrames(
+        out, in,
+        [&](const uint8_t *src, size_t n) -> size_t {
+          const ssize_t sent = ::send(fd, src, n, SEND_FLAGS);
+          return sent >= 0 ? static_cast<size_t>(sent) : drained("send");
+        },
+        [&](uint8_t *dst, size_t n) -> size_t {
+          const ssize_t got = ::recv(fd, dst, n, 0);
+          if (got == 0) {
+            throw std::runtime_error("Peer closed the connection");
+          }
+          return got > 0 ? static_cast<size_t>(got) : drained("recv");
+        },
+        [&](bool sending) {
+          pollfd p{fd, static_cast<short>(POLLIN | (sending ? POLLOUT : 0)), 0};
+          poll(&p, 1, 100);
+        });
+  }
+
+private:
+  int self;
+  int count;
+  std::vector<int> peers;
+
+  // A non-blocking call that would block moved zero bytes; anything else is fatal
+  static size_t drained(const char *call) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return 0;
+    }
+    throw std::runtime_error(std::string("Socket ") + call + " failed");
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Transport> createSocketTransport(const std::vector<std::string> &endpoints,
+                                                 int rank) {
+  return std::make_unique<SocketTransport>(endpoints, rank);
+}
@@ -0,0 +1,24 @@
+#include "Transport.h"
+
+void Transport::allToAll(const std::vector<Buffer> &out, std::vector<Buffer> &in) {
+  const int n = size();
+  const int self = rank();
+  in.resize(n);
+  in[self] = out[self];
+
+  for (int round = 0; round < n; ++round) {
+    const int peer = ((round - self) % n + n) % n;
+    if (peer != self) {
+      exchange(peer, out[peer], in[peer]);
+    }
+  }
+}
+
+void Transport::allGather(const Buffer &local, std::vector<Buffer> &all) {
+  allToAll(std::vector<Buffer>(size(), local), all);
+}
+
+void Transport::barrier() {
+  std::vector<Buffer> ignored;
+  allGather({}, ignored);
+}
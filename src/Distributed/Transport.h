@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Buffer = std::vector<uint8_t>;
+
+// Framed byte messages between the ranks of a distributed run. A receive always yields exactly
+// one send. exchange() sends to and receives from one peer at the same time, so two ranks
+// swapping buffers larger than the underlying pipe cannot deadlock waiting on each other.
+class Transport {
+public:
+  virtual ~Transport() = default;
+
+  [[nodiscard]] virtual int rank() const = 0;
+  [[nodiscard]] virtual int size() const = 0;
+  virtual void exchange(int peer, const Buffer &out, Buffer &in) = 0;
+
+  // out[r] goes to rank r and in[r] arrives from it; the own slot is copied across. Runs in
+  // size() rounds pairing rank i with (round - i) mod size, so every pair meets exactly once
+  // and no rank waits on a peer that is busy with someone else.
+  void allToAll(const std::vector<Buffer> &out, std::vector<Buffer> &in);
+  void allGather(const Buffer &local, std::vector<Buffer> &all);
+  void barrier();
+};
+
+// Local ranks on one machine: one POSIX shared memory segment holding a ring per rank pair.
+// The first rank to open the segment creates it; rank 0 unlinks it on destruction.
+std::unique_ptr<Transport> createSharedMemoryTransport(const std::string &name, int rank,
+                                                       int size);
+
+// Ranks on any hosts: a full TCP mesh. endpoints[r] is "host:port" of rank r, which listens on
+// that port, connects to every lower rank and accepts every higher one.
+std::unique_ptr<Transport> createSocketTransport(const std::vector<std::string> &endpoints,
+                                                 int rank);
@@ -1,12 +1,28 @@
 #include "GUI/gui.h"
 #include <algorithm>
+#include <cstring>
 #include <imgui.h>
+#include "../Graphics/Camera2D.h"
+#include "../Graphics/CommandQueue.h"
+#include "../Graphics/GenomePool.h"
+#include "../Graphics/ObstacleField.h"
+#include "../Graphics/Particle.h"
 #include "../Graphics/Simulation.h"
 #include "Common.h"
 #include "core/system_utils.h"
 
 namespace gui {
 
+namespace {
+// Widgets edit copies; a change travels through the command queue and lands at the next step
+// boundary, never while a step is reading the setting. A change the full queue holds back is
+// still delivered, after the ones before it.
+template <typename T>
+void submit(T &setting, const T &value, uint32_t dirty = simulation::DIRTY_NONE) {
+  simulation::commands().set(setting, value, dirty);
+}
+} // namespace
+
 // void PerformanceWindow(const FpsCounter &fpsCounter) {
 //   // Performance metrics section
 //   if (ImGui::CollapsingHeader("Performance Metrics", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -70,9 +86,16 @@ namespace gui {
 void PerformanceWindow(const FpsCounter &fpsCounter) {
   // Performance metrics section
   if (ImGui::CollapsingHeader("Performance Metrics", ImGuiTreeNodeFlags_DefaultOpen)) {
-    // Get current CPU and GPU metrics
-    float cpuUsage = SystemUtils::getApplicationCPUUsage();
-    float memoryUsage = SystemUtils::getApplicationMemoryUsage();
+    // The metrics come from /proc and friends, so they are sampled twice a second rather than
+    // every frame
+    static float cpuUsage = 0.0F;
+    static float memoryUsage = 0.0F;
+    static double lastSample = -1.0;
+    if (lastSample < 0.0 || ImGui::GetTime() - lastSample >= 0.5) {
+      cpuUsage = SystemUtils::getApplicationCPUUsage();
+      memoryUsage = SystemUtils::getApplicationMemoryUsage();
+      lastSample = ImGui::GetTime();
+    }
 
     // Create two columns for metrics display
     ImGui::Columns(2, "perfMetrics");
@@ -104,6 +127,123 @@ void PerformanceWindow(const FpsCounter &fpsCounter) {
     ImGui::Text("CPU App: %.1f%%", cpuUsage);
     ImGui::PopStyleColor();
 
+    // GPU trail history
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.6F, 0.8F, 0.8F, 1.0F));
+    ImGui::Text("Trails: %.1f MB",
+                static_cast<float>(Particle::getTrailMemoryUsage()) / (1024.0F * 1024.0F));
+    ImGui::PopStyleColor();
+
+    // Simulation step breakdown
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    ImGui::Text("Forces: %.2f ms", simulation::forceStats.stepMs);
+    ImGui::PopStyleColor();
+
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.9F, 0.7F, 0.5F, 1.0F));
+    if (simulation::contacts.enabled) {
+      ImGui::Text("Contacts: %.2f ms", simulation::contactStats.stepMs);
+    } else {
+      ImGui::TextDisabled("Contacts: off");
+    }
+    ImGui::PopStyleColor();
+
+    // Incremental grid maintenance
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.6F, 0.9F, 0.7F, 1.0F));
+    ImGui::Text("Grid Moves: %.1f%%", simulation::gridStats.migrationRate * 100.0F);
+    ImGui::PopStyleColor();
+
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.6F, 0.9F, 0.7F, 1.0F));
+    ImGui::Text("Grid Rebuild: %zu steps", simulation::gridStats.rebuildSpacing);
+    ImGui::PopStyleColor();
+
+    // Frame governor decisions
+    const simulation::GovernorStats &governed = simulation::governorStats;
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7F, 0.5F, 1.0F, 1.0F));
+    ImGui::Text("Steps/Frame: %d (%.0f%% speed)", governed.subSteps, governed.simRate * 100.0F);
+    ImGui::PopStyleColor();
+
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, governed.reducedRender ? ImVec4(1.0F, 0.6F, 0.3F, 1.0F)
+                                                                : ImVec4(0.7F, 0.5F, 1.0F, 1.0F));
+    if (governed.keepRatio < 1.0F) {
+      ImGui::Text("Render: %.2f ms (%.0f%% drawn)", governed.renderMs, governed.keepRatio * 100.0F);
+    } else {
+      ImGui::Text("Render: %.2f ms%s", governed.renderMs,
+                  governed.reducedRender ? " (reduced)" : "");
+    }
+    ImGui::PopStyleColor();
+
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7F, 0.5F, 1.0F, 1.0F));
+    ImGui::Text("Particle GPU: %.2f ms", governed.particleGpuMs);
+    ImGui::PopStyleColor();
+
+    ImGui::NextColumn();
+    ImGui::PushStyleColor(ImGuiCol_Text, governed.renderScale < 1.0F
+                                             ? ImVec4(1.0F, 0.6F, 0.3F, 1.0F)
+                                             : ImVec4(0.7F, 0.5F, 1.0F, 1.0F));
+    ImGui::Text("Resolution: %.0f%%", governed.renderScale * 100.0F);
+    ImGui::PopStyleColor();
+
+    ImGui::Columns(1);
+
+    simulation::GovernorSettings governor = simulation::governor;
+    bool governorChanged = false;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    governorChanged |= ImGui::Checkbox("Frame Budget", &governor.enabled);
+    ImGui::PopStyleColor();
+    if (governor.enabled) {
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      governorChanged |=
+          ImGui::SliderFloat("Target Frame", &governor.targetMs, 8.0F, 50.0F, "%.1f ms");
+      governorChanged |= ImGui::SliderInt("Max Steps/Frame", &governor.maxSubSteps, 1, 16);
+      ImGui::PopStyleColor();
+      ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+      governorChanged |= ImGui::Checkbox("Thin Out Particles", &governor.decimate);
+      ImGui::PopStyleColor();
+      if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Draws a stable subset with larger particles while drawing overruns "
+                          "the budget; the simulation is unchanged");
+      }
+      ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+      governorChanged |= ImGui::Checkbox("Dynamic Resolution", &governor.dynamicResolution);
+      ImGui::PopStyleColor();
+    }
+    if (governorChanged) {
+      submit(simulation::governor, governor);
+    }
+
+    // Each path keeps its last measured draw time, so switching through them lines them up
+    int geometry = simulation::particleGeometry;
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+    const char *geometries[] = {"Indexed Quads", "Generated Quads", "Point Sprites"};
+    if (ImGui::Combo("Particle Geometry", &geometry, geometries, IM_ARRAYSIZE(geometries))) {
+      submit(simulation::particleGeometry, geometry);
+    }
+    ImGui::PopStyleColor();
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Compare at a fixed particle count and view, with the frame budget off "
+                        "so resolution and thinning stay put");
+    }
+    ImGui::Columns(simulation::GEOMETRY_COUNT, "geometryTimes", false);
+    for (int g = 0; g < simulation::GEOMETRY_COUNT; ++g) {
+      const float ms = governed.geometryGpuMs[g];
+      ImGui::PushStyleColor(ImGuiCol_Text, g == simulation::particleGeometry
+                                               ? ImVec4(0.4F, 0.8F, 1.0F, 1.0F)
+                                               : ImVec4(0.6F, 0.6F, 0.6F, 1.0F));
+      if (ms > 0.0F) {
+        ImGui::Text("%s: %.2f ms", geometries[g], ms);
+      } else {
+        ImGui::Text("%s: -", geometries[g]);
+      }
+      ImGui::PopStyleColor();
+      ImGui::NextColumn();
+    }
     ImGui::Columns(1);
 
     // Tabbed graphs section
@@ -232,9 +372,9 @@ void RenderGui(const FpsCounter &fpsCounter) {
   ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
   ImGui::PushStyleColor(ImGuiCol_SliderGrab, ImVec4(0.3F, 0.7F, 0.9F, 1.0F));
   ImGui::PushStyleColor(ImGuiCol_SliderGrabActive, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
-  if (ImGui::DragFloat("Simulation Speed", &simulation::simulationSpeed, 0.1F, 0.1F, 25.0F,
-                       "%.1fx")) {
-    simulation::simulationSpeed = std::max(simulation::simulationSpeed, 0.1F);
+  float speed = simulation::simulationSpeed;
+  if (ImGui::DragFloat("Simulation Speed", &speed, 0.1F, 0.1F, 25.0F, "%.1fx")) {
+    submit(simulation::simulationSpeed, std::max(speed, 0.1F));
   }
   ImGui::PopStyleColor(3);
 
@@ -256,14 +396,17 @@ void RenderGui(const FpsCounter &fpsCounter) {
 
   // Particle count input
   ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
-  ImGui::DragInt("Desired Particle Count", &simulation::desiredParticleCount, 1, 0, 100000);
+  int desiredCount = simulation::desiredParticleCount;
+  if (ImGui::DragInt("Desired Particle Count", &desiredCount, 1, 0, 100000)) {
+    submit(simulation::desiredParticleCount, desiredCount);
+  }
   ImGui::PopStyleColor();
 
   // Create and Clear buttons
   ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2F, 0.7F, 0.2F, 1.0F));
   ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3F, 0.8F, 0.3F, 1.0F));
   if (ImGui::Button("Create Particles", ImVec2(ImGui::GetContentRegionAvail().x * 0.5F, 0))) {
-    simulation::shouldCreateParticles = true;
+    submit(simulation::shouldCreateParticles, true);
   }
   ImGui::PopStyleColor(2);
 
@@ -272,7 +415,7 @@ void RenderGui(const FpsCounter &fpsCounter) {
   ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7F, 0.2F, 0.2F, 1.0F));
   ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.8F, 0.3F, 0.3F, 1.0F));
   if (ImGui::Button("Clear Particles", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
-    simulation::shouldClearParticles = true;
+    submit(simulation::shouldClearParticles, true);
   }
   ImGui::PopStyleColor(2);
 
@@ -287,19 +430,416 @@ void RenderGui(const FpsCounter &fpsCounter) {
 
     // Boundary toggle with custom checkbox
     ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
-    ImGui::Checkbox("Enable Boundaries", &simulation::enableBounds);
+    bool bounds = simulation::enableBounds;
+    if (ImGui::Checkbox("Enable Boundaries", &bounds)) {
+      submit(simulation::enableBounds, bounds, simulation::DIRTY_BOUNDS);
+    }
+    ImGui::PopStyleColor();
+
+    if (bounds) {
+      float left = simulation::boundaryLeft;
+      float right = simulation::boundaryRight;
+      float top = simulation::boundaryTop;
+      float bottom = simulation::boundaryBottom;
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      if (ImGui::DragFloat("Left Boundary", &left, 1.0F, -WINDOW_WIDTH / 2.0F,
+                           WINDOW_WIDTH / 2.0F)) {
+        submit(simulation::boundaryLeft, left, simulation::DIRTY_BOUNDS);
+      }
+      if (ImGui::DragFloat("Right Boundary", &right, 1.0F, -WINDOW_WIDTH / 2.0F,
+                           WINDOW_WIDTH / 2.0F)) {
+        submit(simulation::boundaryRight, right, simulation::DIRTY_BOUNDS);
+      }
+      if (ImGui::DragFloat("Top Boundary", &top, 1.0F, -WINDOW_HEIGHT / 2.0F,
+                           WINDOW_HEIGHT / 2.0F)) {
+        submit(simulation::boundaryTop, top, simulation::DIRTY_BOUNDS);
+      }
+      if (ImGui::DragFloat("Bottom Boundary", &bottom, 1.0F, -WINDOW_HEIGHT / 2.0F,
+                           WINDOW_HEIGHT / 2.0F)) {
+        submit(simulation::boundaryBottom, bottom, simulation::DIRTY_BOUNDS);
+      }
+      ImGui::PopStyleColor();
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Camera
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Camera")) {
+    ImGui::Indent(10.0F);
+    ImGui::TextDisabled("Wheel zooms at the cursor, right drag pans");
+
+    simulation::View2D view = simulation::view2D;
+    bool changed = false;
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+    changed |= ImGui::SliderFloat("Zoom", &view.zoom, Camera2D::MIN_ZOOM, Camera2D::MAX_ZOOM,
+                                  "%.2fx", ImGuiSliderFlags_Logarithmic);
+    ImGui::PopStyleColor();
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    changed |= ImGui::Checkbox("Cull Off-Screen Particles", &view.cull);
+    ImGui::PopStyleColor();
+    if (ImGui::Button("Reset View")) {
+      view.centerX = 0.0F;
+      view.centerY = 0.0F;
+      view.zoom = 1.0F;
+      changed = true;
+    }
+    if (changed) {
+      submit(simulation::view2D, view);
+    }
+    ImGui::Text("Drawn: %zu particles", Particle::getDrawnCount());
+    ImGui::Unindent(10.0F);
+  }
+
+  // 3D Mode
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("3D Mode")) {
+    ImGui::Indent(10.0F);
+
+    bool is3D = simulation::dimensions == 3;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("3D Simulation", &is3D)) {
+      submit(simulation::dimensions, is3D ? 3 : 2);
+    }
     ImGui::PopStyleColor();
 
-    if (simulation::enableBounds) {
+    if (is3D) {
+      simulation::View3D view = simulation::view3D;
+      bool changed = false;
       ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
-      ImGui::DragFloat("Left Boundary", &simulation::boundaryLeft, 1.0F, -WINDOW_WIDTH / 2.0F,
-                       WINDOW_WIDTH / 2.0F);
-      ImGui::DragFloat("Right Boundary", &simulation::boundaryRight, 1.0F, -WINDOW_WIDTH / 2.0F,
-                       WINDOW_WIDTH / 2.0F);
-      ImGui::DragFloat("Top Boundary", &simulation::boundaryTop, 1.0F, -WINDOW_HEIGHT / 2.0F,
-                       WINDOW_HEIGHT / 2.0F);
-      ImGui::DragFloat("Bottom Boundary", &simulation::boundaryBottom, 1.0F, -WINDOW_HEIGHT / 2.0F,
-                       WINDOW_HEIGHT / 2.0F);
+      changed |= ImGui::DragFloat("Box Depth", &view.depth, 5.0F, 60.0F, 4000.0F, "%.0f px");
+      changed |= ImGui::SliderFloat("Yaw", &view.yaw, 0.0F, 360.0F, "%.0f deg");
+      changed |= ImGui::SliderFloat("Pitch", &view.pitch, -89.0F, 89.0F, "%.0f deg");
+      changed |=
+          ImGui::DragFloat("Camera Distance", &view.distance, 10.0F, 100.0F, 10000.0F, "%.0f");
+      changed |= ImGui::SliderFloat("Spin", &view.spinSpeed, -45.0F, 45.0F, "%.1f deg/s");
+      changed |= ImGui::SliderFloat("Point Size", &view.pointSize, 1.0F, 30.0F, "%.1f");
+      ImGui::PopStyleColor();
+      if (changed) {
+        submit(simulation::view3D, view);
+      }
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Obstacles
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Obstacles")) {
+    ImGui::Indent(10.0F);
+
+    simulation::ObstacleSettings &obs = simulation::obstacles;
+    bool enabled = obs.enabled;
+    bool show = obs.show;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("Enable Obstacles", &enabled)) {
+      submit(obs.enabled, enabled);
+    }
+    ImGui::SameLine();
+    if (ImGui::Checkbox("Show##obstacles", &show)) {
+      submit(obs.show, show);
+    }
+    ImGui::PopStyleColor();
+
+    if (enabled) {
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      const char *presets[] = {"None", "Pillars", "Maze", "Star", "Bitmap (PGM)"};
+      int preset = obs.preset;
+      if (ImGui::Combo("Map", &preset, presets, IM_ARRAYSIZE(presets))) {
+        submit(obs.preset, preset, simulation::DIRTY_OBSTACLES);
+      }
+      if (preset == ObstacleField::PRESET_BITMAP) {
+        char path[sizeof(obs.bitmapPath)];
+        std::memcpy(path, obs.bitmapPath, sizeof(path));
+        if (ImGui::InputText("File", path, sizeof(path))) {
+          submit(obs.bitmapPath, path);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Load")) {
+          submit(obs.rebuild, true, simulation::DIRTY_OBSTACLES);
+        }
+      }
+      float cellSize = obs.cellSize;
+      if (ImGui::SliderFloat("Field Resolution", &cellSize, 1.0F, 32.0F, "%.1f px")) {
+        submit(obs.cellSize, cellSize, simulation::DIRTY_OBSTACLES);
+      }
+      float restitution = obs.restitution;
+      if (ImGui::SliderFloat("Restitution", &restitution, 0.0F, 1.0F, "%.2f")) {
+        submit(obs.restitution, restitution);
+      }
+      ImGui::PopStyleColor();
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Contacts
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Contacts")) {
+    ImGui::Indent(10.0F);
+
+    simulation::ContactSettings contacts = simulation::contacts;
+    bool changed = false;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    changed |= ImGui::Checkbox("Soft-Body Contacts", &contacts.enabled);
+    ImGui::PopStyleColor();
+
+    if (contacts.enabled) {
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      changed |= ImGui::SliderInt("Iterations", &contacts.iterations, 1, 16);
+      changed |= ImGui::SliderFloat("Relaxation", &contacts.relaxation, 0.05F, 1.0F, "%.2f");
+      changed |=
+          ImGui::SliderFloat("Velocity Feedback", &contacts.velocityFeedback, 0.0F, 1.0F, "%.2f");
+      ImGui::PopStyleColor();
+
+      ImGui::Text("Contacts: %zu", simulation::contactStats.contacts);
+      ImGui::SameLine();
+      ImGui::Text("Solve: %.2f ms", simulation::contactStats.stepMs);
+    }
+    if (changed) {
+      submit(simulation::contacts, contacts);
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Neighbour Grid
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Neighbour Grid")) {
+    ImGui::Indent(10.0F);
+
+    simulation::GridSettings gridSettings = simulation::neighbourGrid;
+    bool changed = false;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    changed |= ImGui::Checkbox("Incremental Updates", &gridSettings.incremental);
+    changed |= ImGui::Checkbox("Tiled Traversal", &gridSettings.tiledTraversal);
+    ImGui::PopStyleColor();
+
+    if (gridSettings.incremental) {
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      changed |=
+          ImGui::SliderInt("Rebuild Every", &gridSettings.rebuildInterval, 2, 1000, "%d steps");
+      ImGui::PopStyleColor();
+    }
+    if (changed) {
+      submit(simulation::neighbourGrid, gridSettings);
+    }
+
+    ImGui::Text("Changed cell: %.2f%% per step", simulation::gridStats.migrationRate * 100.0F);
+    ImGui::Text("Last rebuild spacing: %zu steps", simulation::gridStats.rebuildSpacing);
+    ImGui::Unindent(10.0F);
+  }
+
+  // Species Physics
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Species Physics")) {
+    ImGui::Indent(10.0F);
+
+    bool perSpecies = simulation::useSpeciesPhysics;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("Per-Species Parameters", &perSpecies)) {
+      submit(simulation::useSpeciesPhysics, perSpecies, simulation::DIRTY_SPECIES);
+    }
+    ImGui::PopStyleColor();
+
+    if (perSpecies) {
+      simulation::SpeciesPhysics &table = simulation::species;
+      const int speciesCount =
+          std::min(Particle::getNumParticleTypes(), static_cast<int>(simulation::COLORS.size()));
+
+      // Each field is its own command so a drag never ships the whole table
+      const auto edit = [](float &field, auto &&widget) {
+        float value = field;
+        if (widget(&value)) {
+          submit(field, value, simulation::DIRTY_SPECIES);
+        }
+      };
+
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      for (int s = 0; s < std::min(speciesCount, simulation::MAX_SPECIES); ++s) {
+        const glm::vec3 &c = simulation::COLORS[s];
+        ImGui::PushID(s);
+        ImGui::ColorButton("##swatch", ImVec4(c.r, c.g, c.b, 1.0F), 0, ImVec2(12.0F, 12.0F));
+        ImGui::SameLine();
+        if (ImGui::TreeNode("Species", "Species %d", s)) {
+          const float maxSpeed = table.maxSpeed[s];
+          edit(table.mass[s],
+               [](float *v) { return ImGui::DragFloat("Mass", v, 0.01F, 0.05F, 20.0F, "%.2f"); });
+          edit(table.friction[s],
+               [](float *v) { return ImGui::SliderFloat("Friction", v, 0.0F, 1.0F, "%.3f"); });
+          edit(table.beta[s],
+               [](float *v) { return ImGui::SliderFloat("Beta", v, 0.05F, 0.95F, "%.2f"); });
+          edit(table.maxSpeed[s], [maxSpeed](float *v) {
+            return ImGui::DragFloat("Max Speed", v, 1.0F, 0.0F, 5000.0F,
+                                    maxSpeed > 0.0F ? "%.0f px/s" : "unlimited");
+          });
+          edit(table.collisionRadius[s], [](float *v) {
+            return ImGui::DragFloat("Collision Radius", v, 0.1F, 0.5F, 50.0F, "%.1f px");
+          });
+          ImGui::TreePop();
+        }
+        ImGui::PopID();
+      }
+      ImGui::PopStyleColor();
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Field Overlay
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Field Overlay")) {
+    ImGui::Indent(10.0F);
+
+    bool showOverlay = simulation::showFieldOverlay;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("Show Density/Velocity Field", &showOverlay)) {
+      submit(simulation::showFieldOverlay, showOverlay);
+    }
+    ImGui::PopStyleColor();
+
+    if (showOverlay) {
+      int mode = simulation::fieldOverlayMode;
+      int overlaySpecies = simulation::fieldOverlaySpecies;
+      bool smooth = simulation::smoothFieldOverlay;
+      bool hide = simulation::hideParticlesUnderOverlay;
+
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      const char *overlayModes[] = {"Density Heatmap", "Flow Arrows", "Heatmap + Arrows"};
+      if (ImGui::Combo("Overlay Mode", &mode, overlayModes, IM_ARRAYSIZE(overlayModes))) {
+        submit(simulation::fieldOverlayMode, mode);
+      }
+      if (ImGui::SliderInt("Species", &overlaySpecies, -1, Particle::getNumParticleTypes() - 1,
+                           overlaySpecies < 0 ? "All" : "%d")) {
+        submit(simulation::fieldOverlaySpecies, overlaySpecies);
+      }
+      ImGui::PopStyleColor();
+      if (ImGui::Checkbox("Smooth Field", &smooth)) {
+        submit(simulation::smoothFieldOverlay, smooth);
+      }
+      if (ImGui::Checkbox("Hide Particles", &hide)) {
+        submit(simulation::hideParticlesUnderOverlay, hide);
+      }
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Ecology
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Ecology")) {
+    ImGui::Indent(10.0F);
+
+    bool ecologyMode = simulation::ecologyMode;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("Birth/Death Ecology", &ecologyMode)) {
+      submit(simulation::ecologyMode, ecologyMode);
+    }
+    ImGui::PopStyleColor();
+
+    if (ecologyMode) {
+      simulation::EcologySettings eco = simulation::ecology;
+      bool changed = false;
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      changed |= ImGui::DragFloat("Ambient Gain", &eco.ambientGain, 0.01F, 0.0F, 5.0F, "%.2f/s");
+      changed |= ImGui::DragFloat("Crowding Capacity", &eco.crowdingCapacity, 0.1F, 0.5F, 100.0F);
+      changed |= ImGui::DragFloat("Metabolism", &eco.metabolism, 0.005F, 0.0F, 2.0F, "%.3f/s");
+      changed |=
+          ImGui::DragFloat("Movement Cost", &eco.movementCost, 0.0001F, 0.0F, 0.1F, "%.4f");
+      changed |= ImGui::DragFloat("Reproduce At", &eco.reproduceThreshold, 0.05F, 0.1F, 10.0F);
+      changed |= ImGui::SliderFloat("Offspring Share", &eco.offspringFraction, 0.05F, 0.95F);
+      changed |= ImGui::SliderFloat("Mutation Rate", &eco.mutationRate, 0.0F, 1.0F);
+      changed |= ImGui::DragFloat("Max Age", &eco.maxAge, 1.0F, 1.0F, 1000.0F, "%.0f s");
+      ImGui::PopStyleColor();
+      if (changed) {
+        submit(simulation::ecology, eco);
+      }
+
+      const simulation::EcologyStats &stats = simulation::ecologyStats;
+      ImGui::TextColored(ImVec4(0.5F, 0.9F, 0.5F, 1.0F), "Births: %zu", stats.births);
+      ImGui::SameLine();
+      ImGui::TextColored(ImVec4(0.9F, 0.5F, 0.5F, 1.0F), "Deaths: %zu", stats.deaths);
+      ImGui::Text("Pool: %zu slots, %zu free", stats.poolSize, stats.freeSlots);
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Genomes
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Genomes")) {
+    ImGui::Indent(10.0F);
+
+    int genomeMode = simulation::genomeMode;
+    float mutation = simulation::genomeMutation;
+    int groups = simulation::genomeGroups;
+    int recluster = simulation::genomeReclusterInterval;
+
+    ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+    const char *genomeModes[] = {"Species Matrix", "Genome Dot Product", "Clustered Genomes"};
+    if (ImGui::Combo("Interaction Model", &genomeMode, genomeModes, IM_ARRAYSIZE(genomeModes))) {
+      submit(simulation::genomeMode, genomeMode);
+    }
+    if (genomeMode != simulation::GENOME_OFF &&
+        ImGui::SliderFloat("Trait Mutation", &mutation, 0.0F, 0.3F, "%.3f")) {
+      submit(simulation::genomeMutation, mutation);
+    }
+    if (genomeMode == simulation::GENOME_CLUSTERED) {
+      if (ImGui::SliderInt("Genome Groups", &groups, 2, GenomePool::MAX_GROUPS)) {
+        submit(simulation::genomeGroups, groups);
+      }
+      if (ImGui::SliderInt("Recluster Every", &recluster, 1, 600, "%d steps")) {
+        submit(simulation::genomeReclusterInterval, recluster);
+      }
+    }
+    ImGui::PopStyleColor();
+    ImGui::Unindent(10.0F);
+  }
+
+  // Resource Field
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Resource Field")) {
+    ImGui::Indent(10.0F);
+
+    simulation::ResourceSettings res = simulation::resources;
+    bool changed = false;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    changed |= ImGui::Checkbox("Enable Resources", &res.enabled);
+    ImGui::SameLine();
+    changed |= ImGui::Checkbox("Show", &res.show);
+    ImGui::PopStyleColor();
+
+    if (res.enabled) {
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      changed |= ImGui::DragFloat("Field Cell Size", &res.cellSize, 0.5F, 2.0F, 64.0F, "%.1f px");
+      changed |= ImGui::DragFloat("Diffusion", &res.diffusion, 1.0F, 0.0F, 2000.0F);
+      changed |= ImGui::DragFloat("Decay", &res.decay, 0.001F, 0.0F, 1.0F, "%.3f/s");
+      changed |= ImGui::DragFloat("Regrowth", &res.regrowth, 0.001F, 0.0F, 1.0F, "%.3f/s");
+      changed |=
+          ImGui::DragFloat("Consumption", &res.consumptionRate, 0.01F, 0.0F, 10.0F, "%.2f/s");
+      changed |= ImGui::DragFloat("Gradient Drift", &res.gradientDrift, 1.0F, -500.0F, 500.0F);
+      ImGui::PopStyleColor();
+      ImGui::Text("Stencil: %.2f ms", simulation::resourceStats.stepMs);
+    }
+    if (changed) {
+      res.cellSize = std::max(res.cellSize, 2.0F);
+      submit(simulation::resources, res);
+    }
+    ImGui::Unindent(10.0F);
+  }
+
+  // Motion Trails
+  ImGui::Spacing();
+  if (ImGui::CollapsingHeader("Motion Trails")) {
+    ImGui::Indent(10.0F);
+
+    bool trails = simulation::enableTrails;
+    ImGui::PushStyleColor(ImGuiCol_CheckMark, ImVec4(0.4F, 0.8F, 1.0F, 1.0F));
+    if (ImGui::Checkbox("Enable Trails", &trails)) {
+      submit(simulation::enableTrails, trails);
+    }
+    ImGui::PopStyleColor();
+
+    if (trails) {
+      int length = simulation::trailLength;
+      ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1F, 0.1F, 0.2F, 1.0F));
+      if (ImGui::SliderInt("Trail Length", &length, 2, TrailBuffer::MAX_LENGTH)) {
+        submit(simulation::trailLength, length);
+      }
       ImGui::PopStyleColor();
     }
     ImGui::Unindent(10.0F);
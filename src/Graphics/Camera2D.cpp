@@ -0,0 +1,49 @@
+#include "Camera2D.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+glm::vec2 centerOf(const simulation::View2D &view) { return {view.centerX, view.centerY}; }
+} // namespace
+
+glm::mat4 Camera2D::getProjection(const simulation::View2D &view) const {
+  const glm::vec2 lo = visibleMin(view);
+  const glm::vec2 hi = visibleMax(view);
+  return glm::ortho(lo.x, hi.x, lo.y, hi.y, -1.0F, 1.0F);
+}
+
+glm::vec2 Camera2D::visibleMin(const simulation::View2D &view) const {
+  return centerOf(view) - (frame * 0.5F / view.zoom);
+}
+
+glm::vec2 Camera2D::visibleMax(const simulation::View2D &view) const {
+  return centerOf(view) + (frame * 0.5F / view.zoom);
+}
+
+glm::vec2 Camera2D::screenToWorld(const simulation::View2D &view, const glm::vec2 &screen,
+                                  const glm::vec2 &screenSize) const {
+  const glm::vec2 unit((screen.x / screenSize.x) - 0.5F, 0.5F - (screen.y / screenSize.y));
+  return centerOf(view) + (unit * frame / view.zoom);
+}
+
+simulation::View2D Camera2D::panned(const simulation::View2D &view, const glm::vec2 &pixelDelta,
+                                    const glm::vec2 &screenSize) const {
+  const glm::vec2 worldDelta =
+      glm::vec2(pixelDelta.x, -pixelDelta.y) / screenSize * frame / view.zoom;
+  simulation::View2D result = view;
+  result.centerX -= worldDelta.x;
+  result.centerY -= worldDelta.y;
+  return result;
+}
+
+simulation::View2D Camera2D::zoomedAt(const simulation::View2D &view, const glm::vec2 &screen,
+                                      const glm::vec2 &screenSize, float factor) const {
+  const glm::vec2 anchor = screenToWorld(view, screen, screenSize);
+  simulation::View2D result = view;
+  result.zoom = std::clamp(view.zoom * factor, MIN_ZOOM, MAX_ZOOM);
+  // The anchor keeps its screen position: its offset from the centre shrinks with the zoom
+  const glm::vec2 center = anchor + ((centerOf(view) - anchor) * (view.zoom / result.zoom));
+  result.centerX = center.x;
+  result.centerY = center.y;
+  return result;
+}
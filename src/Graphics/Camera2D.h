@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "Graphics/Simulation.h"
+
+// Orthographic 2D camera. The frame is the world extent shown at zoom 1 (the reference size
+// widened to the window's aspect); a view scales it by 1/zoom around its centre. The camera
+// holds no view state of its own, it maps the simulation::View2D it is given.
+class Camera2D {
+public:
+  static constexpr float MIN_ZOOM = 0.1F;
+  static constexpr float MAX_ZOOM = 200.0F;
+
+  void setFrame(const glm::vec2 &worldFrame) { frame = worldFrame; }
+  [[nodiscard]] glm::vec2 getFrame() const { return frame; }
+
+  [[nodiscard]] glm::mat4 getProjection(const simulation::View2D &view) const;
+  // World-space rectangle covered by the window
+  [[nodiscard]] glm::vec2 visibleMin(const simulation::View2D &view) const;
+  [[nodiscard]] glm::vec2 visibleMax(const simulation::View2D &view) const;
+
+  // Window coordinates (pixels, y down) to world coordinates
+  [[nodiscard]] glm::vec2 screenToWorld(const simulation::View2D &view, const glm::vec2 &screen,
+                                        const glm::vec2 &screenSize) const;
+  // Moves the view with a drag of pixelDelta, so the world point under the cursor follows it
+  [[nodiscard]] simulation::View2D panned(const simulation::View2D &view,
+                                          const glm::vec2 &pixelDelta,
+                                          const glm::vec2 &screenSize) const;
+  // Scales the zoom by factor, keeping the world point under the cursor fixed
+  [[nodiscard]] simulation::View2D zoomedAt(const simulation::View2D &view, const glm::vec2 &screen,
+                                            const glm::vec2 &screenSize, float factor) const;
+
+private:
+  glm::vec2 frame{1280.0F, 720.0F};
+};
@@ -0,0 +1,85 @@
+#include "CommandQueue.h"
+#include <algorithm>
+#include "Graphics/Particle.h"
+
+namespace simulation {
+
+bool CommandQueue::push(const Command &command) {
+  // Anything held back goes first, so commands arrive in the order they were pushed
+  if (!flush()) {
+    backlog.push_back(command);
+    return false;
+  }
+  const size_t h = head.load(std::memory_order_relaxed);
+  if (h - tail.load(std::memory_order_acquire) == CAPACITY) {
+    backlog.push_back(command);
+    return false;
+  }
+  ring[h % CAPACITY] = command;
+  head.store(h + 1, std::memory_order_release);
+  return true;
+}
+
+bool CommandQueue::flush() {
+  if (backlog.empty()) {
+    return true;
+  }
+  size_t h = head.load(std::memory_order_relaxed);
+  const size_t room = CAPACITY - (h - tail.load(std::memory_order_acquire));
+  const size_t count = std::min(room, backlog.size());
+  for (size_t i = 0; i < count; ++i, ++h) {
+    ring[h % CAPACITY] = backlog[i];
+  }
+  head.store(h, std::memory_order_release);
+  backlog.erase(backlog.begin(), backlog.begin() + static_cast<std::ptrdiff_t>(count));
+  return backlog.empty();
+}
+
+bool CommandQueue::setInteraction(int a, int b, float strength) {
+  Command command;
+  command.kind = Command::SET_INTERACTION;
+  command.dirty = DIRTY_MATRIX;
+  command.a = a;
+  command.b = b;
+  command.strength = strength;
+  return push(command);
+}
+
+bool CommandQueue::randomizeInteractions() {
+  Command command;
+  command.kind = Command::RANDOMIZE_INTERACTIONS;
+  command.dirty = DIRTY_MATRIX;
+  return push(command);
+}
+
+uint32_t CommandQueue::drain() {
+  uint32_t dirty = DIRTY_NONE;
+  size_t t = tail.load(std::memory_order_relaxed);
+  const size_t h = head.load(std::memory_order_acquire);
+
+  for (; t != h; ++t) {
+    const Command &command = ring[t % CAPACITY];
+    switch (command.kind) {
+    case Command::SET:
+      std::memcpy(command.target, command.payload, command.size);
+      break;
+    case Command::SET_INTERACTION:
+      Particle::setInteractionStrength(command.a, command.b, command.strength);
+      break;
+    case Command::RANDOMIZE_INTERACTIONS:
+      Particle::randomizeInteractionMatrix();
+      break;
+    }
+    dirty |= command.dirty;
+  }
+
+  tail.store(t, std::memory_order_release);
+  return dirty;
+}
+
+CommandQueue &commands() {
+  static CommandQueue queue;
+  return queue;
+}
+
+} // namespace simulation
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace simulation {
+
+// Derived state a command invalidates. The simulation rebuilds only what the drained commands
+// flagged, instead of revalidating every table each step.
+enum DirtyFlags : uint32_t {
+  DIRTY_NONE = 0,
+  DIRTY_BOUNDS = 1U << 0,    // box extent: grids, obstacle field
+  DIRTY_MATRIX = 1U << 1,    // species interaction matrix
+  DIRTY_SPECIES = 1U << 2,   // per-species beta and mass tables
+  DIRTY_OBSTACLES = 1U << 3, // obstacle map or its resolution
+  DIRTY_ALL = 0xFFFFFFFFU
+};
+
+struct Command {
+  enum Kind : uint8_t { SET, SET_INTERACTION, RANDOMIZE_INTERACTIONS };
+  static constexpr size_t PAYLOAD_BYTES = 256;
+
+  Kind kind = SET;
+  uint32_t dirty = DIRTY_NONE;
+  void *target = nullptr; // SET: the setting overwritten with the payload
+  uint16_t size = 0;
+  int a = 0; // SET_INTERACTION: receiving and source species
+  int b = 0;
+  float strength = 0.0F;
+  alignas(8) unsigned char payload[PAYLOAD_BYTES];
+};
+
+// Lock-free single-producer single-consumer queue carrying parameter changes from the UI to the
+// simulation. The UI pushes; the simulation drains at step boundaries, so settings never change
+// while a step reads them from many threads. When the ring is full, commands wait in a
+// producer-side backlog and go out in order on later pushes or flush(), so no edit is lost.
+class CommandQueue {
+public:
+  static constexpr size_t CAPACITY = 256;
+
+  // Producer side. Returns false when the command was held back rather than queued; it is still
+  // delivered, after everything pushed before it.
+  bool push(const Command &command);
+  // Moves held commands into the ring as far as it has room; call once per frame
+  bool flush();
+
+  template <typename T> bool set(T &setting, const T &value, uint32_t dirty = DIRTY_NONE) {
+    static_assert(std::is_trivially_copyable_v<T>, "settings are copied byte-wise");
+    static_assert(sizeof(T) <= Command::PAYLOAD_BYTES, "setting too large for one command");
+    Command command;
+    command.kind = Command::SET;
+    command.dirty = dirty;
+    command.target = &setting;
+    command.size = static_cast<uint16_t>(sizeof(T));
+    std::memcpy(command.payload, &value, sizeof(T));
+    return push(command);
+  }
+
+  bool setInteraction(int a, int b, float strength);
+  bool randomizeInteractions();
+
+  // Consumer side: applies every queued command and returns the union of their dirty flags
+  uint32_t drain();
+
+private:
+  std::array<Command, CAPACITY> ring;
+  std::vector<Command> backlog; // producer only: commands the full ring could not take
+  alignas(64) std::atomic<size_t> head{0}; // next slot to write, owned by the producer
+  alignas(64) std::atomic<size_t> tail{0}; // next slot to read, owned by the consumer
+};
+
+// The queue between the GUI and the particle system
+CommandQueue &commands();
+
+} // namespace simulation
@@ -0,0 +1,140 @@
+#include "ContactSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "Graphics/Simulation.h"
+
+float ContactSolver::gather(const std::vector<Particle> &particles) {
+  const size_t n = particles.size();
+  positions.resize(n);
+  initial.resize(n);
+  corrections.resize(n);
+  radii.resize(n);
+  invMass.resize(n);
+
+  // Inverse masses per species, so particles load theirs instead of dividing
+  alignas(64) float invMassOf[simulation::MAX_SPECIES];
+  for (int t = 0; t < simulation::MAX_SPECIES; ++t) {
+    invMassOf[t] =
+        simulation::useSpeciesPhysics ? 1.0F / std::max(simulation::species.mass[t], 0.01F) : 1.0F;
+  }
+  float maxRadius = 0.0F;
+
+#pragma omp parallel for schedule(static) reduction(max : maxRadius)
+  for (int i = 0; i < static_cast<int>(n); ++i) {
+    const Particle &p = particles[i];
+    const int t = std::clamp(p.getType(), 0, simulation::MAX_SPECIES - 1);
+    positions[i] = p.getPos();
+    initial[i] = positions[i];
+    radii[i] = p.getCollisionRadius();
+    invMass[i] = invMassOf[t];
+    if (p.isActive()) {
+      maxRadius = std::max(maxRadius, radii[i]);
+    }
+  }
+  return maxRadius;
+}
+
+void ContactSolver::bin(float maxRadius) {
+  // Two discs can only touch if their centres are within one cell of each other
+  const glm::vec2 extent(simulation::boundaryRight - simulation::boundaryLeft,
+                         simulation::boundaryBottom - simulation::boundaryTop);
+  const float cellSize = std::max(2.0F * maxRadius, 1.0F);
+  grid.resize(cellSize, -extent * 0.5F, extent, positions.size());
+
+  cells.assign(positions.size(), -1);
+#pragma omp parallel for schedule(static)
+  for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+    const size_t i = activeParticles[idx];
+    cells[i] = grid.cellOf(positions[i]);
+  }
+  grid.update(cells.data(), cells.size());
+}
+
+size_t ContactSolver::iterate(float relaxation) {
+  size_t contacts = 0;
+
+#pragma omp parallel for schedule(static) reduction(+ : contacts)
+  for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+    const size_t i = activeParticles[idx];
+    const glm::vec2 pos_i = positions[i];
+    const float r_i = radii[i];
+    const float w_i = invMass[i];
+    glm::vec2 correction(0.0F);
+
+    grid.forEachNeighbourCell(grid.getParticleCell(i), [&](int cell) {
+      for (size_t j : grid.getCell(cell)) {
+        const glm::vec2 dist = positions[j] - pos_i;
+        const float distSqr = glm::dot(dist, dist);
+        const float contactDist = r_i + radii[j];
+        if (i == j || distSqr >= contactDist * contactDist) {
+          continue;
+        }
+
+        // Coincident centres are split along x, in opposite directions for the two partners
+        const float distance = std::sqrt(distSqr);
+        const glm::vec2 normal =
+            distance > 1e-6F ? dist / distance : glm::vec2(i < j ? 1.0F : -1.0F, 0.0F);
+        const float share = w_i / (w_i + invMass[j]);
+        correction -= normal * ((contactDist - distance) * share);
+        ++contacts;
+      }
+    });
+    corrections[i] = correction * relaxation;
+  }
+
+#pragma omp parallel for schedule(static)
+  for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+    const size_t i = activeParticles[idx];
+    positions[i] += corrections[i];
+  }
+
+  // Every contact was seen from both sides
+  return contacts / 2;
+}
+
+void ContactSolver::solve(std::vector<Particle> &particles, float deltaTime) {
+  const auto start = std::chrono::high_resolution_clock::now();
+  const simulation::ContactSettings &settings = simulation::contacts;
+
+  activeParticles.clear();
+  for (size_t i = 0; i < particles.size(); ++i) {
+    if (particles[i].isActive()) {
+      activeParticles.push_back(i);
+    }
+  }
+
+  contactCount = 0;
+  if (!activeParticles.empty() && deltaTime > 0.0F) {
+    const float maxRadius = gather(particles);
+    bin(maxRadius);
+
+    // Particles move by a fraction of a radius per iteration, so one binning serves them all
+    for (int it = 0; it < settings.iterations; ++it) {
+      const size_t contacts = iterate(settings.relaxation);
+      if (it == 0) {
+        contactCount = contacts;
+      }
+      if (contacts == 0) {
+        break;
+      }
+    }
+
+    const float velocityScale = settings.velocityFeedback / deltaTime;
+
+#pragma omp parallel for schedule(static)
+    for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+      const size_t i = activeParticles[idx];
+      const glm::vec2 delta = positions[i] - initial[i];
+      if (delta.x != 0.0F || delta.y != 0.0F) {
+        particles[i].setPos(positions[i]);
+        particles[i].setVel(particles[i].getVel() + delta * velocityScale);
+      }
+    }
+  }
+
+  simulation::contactStats.contacts = contactCount;
+  simulation::contactStats.stepMs =
+      std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start)
+          .count();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Graphics/Particle.h"
+#include "Graphics/SpatialGrid.h"
+
+// Short-range contact resolution between particle discs. Overlapping pairs are found on a grid
+// of its own whose cells span the largest contact diameter, far finer than the R_MAX grid used
+// for interactions. Each Jacobi iteration reads only the previous iterate, so every particle is
+// projected in parallel without colouring; the net displacement is fed back into velocity.
+class ContactSolver {
+public:
+  void solve(std::vector<Particle> &particles, float deltaTime);
+
+  [[nodiscard]] size_t getContactCount() const { return contactCount; }
+
+private:
+  SpatialGrid grid;
+  std::vector<size_t> activeParticles;
+  std::vector<int> cells;
+  std::vector<glm::vec2> positions;
+  std::vector<glm::vec2> initial;
+  std::vector<glm::vec2> corrections;
+  std::vector<float> radii;
+  std::vector<float> invMass;
+  size_t contactCount = 0;
+
+  float gather(const std::vector<Particle> &particles);
+  void bin(float maxRadius);
+  size_t iterate(float relaxation);
+};
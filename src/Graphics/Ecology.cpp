@@ -0,0 +1,209 @@
+#include "Ecology.h"
+#include <algorithm>
+#include <omp.h>
+#include "Graphics/Simulation.h"
+
+void Ecology::reset() {
+  energy.clear();
+  age.clear();
+  freeSlots.clear();
+  for (auto &buffer : killBuffers) {
+    buffer.clear();
+  }
+  for (auto &buffer : spawnBuffers) {
+    buffer.clear();
+  }
+}
+
+bool Ecology::acquireSlot(size_t &slot) {
+  if (freeSlots.empty()) {
+    return false;
+  }
+  slot = freeSlots.back();
+  freeSlots.pop_back();
+  onParticleCreated(slot);
+  return true;
+}
+
+void Ecology::onParticleCreated(size_t index) {
+  if (index < energy.size()) {
+    energy[index] = simulation::ecology.initialEnergy;
+    age[index] = 0.0F;
+  }
+}
+
+void Ecology::ensureCapacity(size_t count, size_t maxParticles) {
+  // Reserve the whole pool once so the per-particle state never moves during churn
+  if (energy.capacity() < maxParticles) {
+    energy.reserve(maxParticles);
+    age.reserve(maxParticles);
+    freeSlots.reserve(maxParticles);
+  }
+  if (energy.size() < count) {
+    energy.resize(count, simulation::ecology.initialEnergy);
+    age.resize(count, 0.0F);
+  }
+
+  const auto threads = static_cast<size_t>(omp_get_max_threads());
+  if (killBuffers.size() < threads) {
+    killBuffers.resize(threads);
+    spawnBuffers.resize(threads);
+    std::random_device rd;
+    while (generators.size() < threads) {
+      generators.emplace_back(rd() ^ (generators.size() * 0x9e3779b97f4a7c15ULL));
+    }
+  }
+}
+
+void Ecology::step(std::vector<Particle> &particles, const SpatialGrid &grid,
+                   const std::vector<float> *intake, GenomePool *genomes, float deltaTime,
+                   size_t maxParticles) {
+  const simulation::EcologySettings &settings = simulation::ecology;
+  const int numTypes = Particle::getNumParticleTypes();
+  const bool useGrid = grid.getCellCount() > 0;
+
+  ensureCapacity(particles.size(), maxParticles);
+  for (size_t t = 0; t < killBuffers.size(); ++t) {
+    killBuffers[t].clear();
+    spawnBuffers[t].clear();
+  }
+
+#pragma omp parallel
+  {
+    const int thread = omp_get_thread_num();
+    std::vector<size_t> &kills = killBuffers[thread];
+    std::vector<SpawnRequest> &spawns = spawnBuffers[thread];
+    std::mt19937 &gen = generators[thread];
+    std::uniform_real_distribution<float> chance(0.0F, 1.0F);
+    std::uniform_int_distribution<int> anyType(0, std::max(numTypes - 1, 0));
+
+#pragma omp for schedule(static)
+    for (int ii = 0; ii < static_cast<int>(particles.size()); ++ii) {
+      const auto i = static_cast<size_t>(ii);
+      const Particle &p = particles[i];
+      if (!p.isActive()) {
+        continue;
+      }
+
+      // Ambient intake is shared between the occupants of a cell, which gives each cell a
+      // carrying capacity; motion and upkeep drain energy
+      float gain = 0.0F;
+      if (intake != nullptr) {
+        gain = i < intake->size() ? (*intake)[i] : 0.0F;
+      } else {
+        float crowding = 1.0F;
+        if (useGrid) {
+          const auto occupants =
+              static_cast<float>(grid.getCell(grid.cellOf(p.getPos())).size());
+          crowding = 1.0F + (occupants / settings.crowdingCapacity);
+        }
+        gain = settings.ambientGain / crowding * deltaTime;
+      }
+      const float speed = glm::length(p.getVel());
+      energy[i] += gain - ((settings.metabolism + (settings.movementCost * speed)) * deltaTime);
+      age[i] += deltaTime;
+
+      if (energy[i] <= 0.0F || age[i] > settings.maxAge) {
+        kills.push_back(i);
+      } else if (energy[i] >= settings.reproduceThreshold) {
+        const float childEnergy = energy[i] * settings.offspringFraction;
+        energy[i] -= childEnergy;
+        const int type = chance(gen) < settings.mutationRate ? anyType(gen) : p.getType();
+        spawns.push_back({i, childEnergy, type});
+      }
+    }
+  }
+
+  mergeKills(particles);
+  const size_t births = mergeSpawns(particles, genomes, maxParticles);
+
+  size_t deaths = 0;
+  for (const auto &buffer : killBuffers) {
+    deaths += buffer.size();
+  }
+  simulation::ecologyStats.births = births;
+  simulation::ecologyStats.deaths = deaths;
+  simulation::ecologyStats.freeSlots = freeSlots.size();
+  simulation::ecologyStats.poolSize = particles.size();
+}
+
+void Ecology::mergeKills(std::vector<Particle> &particles) {
+  const size_t threads = killBuffers.size();
+  std::vector<size_t> offsets(threads + 1, 0);
+  for (size_t t = 0; t < threads; ++t) {
+    offsets[t + 1] = offsets[t] + killBuffers[t].size();
+  }
+
+  const size_t base = freeSlots.size();
+  freeSlots.resize(base + offsets[threads]);
+
+#pragma omp parallel for schedule(static, 1)
+  for (int t = 0; t < static_cast<int>(threads); ++t) {
+    size_t out = base + offsets[t];
+    for (size_t i : killBuffers[t]) {
+      particles[i].setActive(false);
+      freeSlots[out++] = i;
+    }
+  }
+}
+
+size_t Ecology::mergeSpawns(std::vector<Particle> &particles, GenomePool *genomes,
+                            size_t maxParticles) {
+  const size_t threads = spawnBuffers.size();
+  std::vector<size_t> offsets(threads + 1, 0);
+  for (size_t t = 0; t < threads; ++t) {
+    offsets[t + 1] = offsets[t] + spawnBuffers[t].size();
+  }
+
+  // The pool only grows until it reaches its steady-state size; the vector was reserved to
+  // maxParticles up front, so emplace_back here never reallocates
+  size_t requested = offsets[threads];
+  while (freeSlots.size() < requested && particles.size() < maxParticles) {
+    particles.emplace_back();
+    particles.back().setActive(false);
+    freeSlots.push_back(particles.size() - 1);
+  }
+  ensureCapacity(particles.size(), maxParticles);
+  if (genomes != nullptr) {
+    genomes->resize(particles.size());
+  }
+
+  const size_t granted = std::min(requested, freeSlots.size());
+  const size_t top = freeSlots.size();
+  const float spacing = simulation::ecology.spawnDistance;
+  const float mutation = simulation::genomeMutation;
+
+#pragma omp parallel for schedule(static, 1)
+  for (int t = 0; t < static_cast<int>(threads); ++t) {
+    std::mt19937 &gen = generators[t];
+    std::uniform_real_distribution<float> jitter(-spacing, spacing);
+
+    for (size_t k = 0; k < spawnBuffers[t].size(); ++k) {
+      const size_t ticket = offsets[t] + k;
+      const SpawnRequest &request = spawnBuffers[t][k];
+      if (ticket >= granted) {
+        // Pool exhausted: the parent keeps the energy it would have passed on
+        energy[request.parent] += request.energy;
+        continue;
+      }
+
+      const size_t slot = freeSlots[top - 1 - ticket];
+      const Particle &parent = particles[request.parent];
+      Particle &child = particles[slot];
+      child.setPos(parent.getPos() + glm::vec2(jitter(gen), jitter(gen)));
+      child.setVel(parent.getVel() * 0.5F);
+      child.setRadius(parent.getSize());
+      child.setType(request.type);
+      if (genomes != nullptr) {
+        genomes->inherit(slot, request.parent, mutation, gen);
+        child.setDisplayColor(genomes->colorOf(slot));
+      }
+      child.setActive(true);
+      energy[slot] = request.energy;
+      age[slot] = 0.0F;
+    }
+  }
+
+  freeSlots.resize(top - granted);
+  return granted;
+}
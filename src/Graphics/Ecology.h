@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "Graphics/GenomePool.h"
+#include "Graphics/Particle.h"
+#include "Graphics/SpatialGrid.h"
+
+// Birth/death lifecycle on top of the particle vector. Dead particles are deactivated in place
+// and their slots go on a free list that offspring are drawn from, so steady-state churn never
+// reallocates the vector or compacts it. Each thread collects kills and spawns in its own
+// buffer during the sweep and the buffers are merged in parallel at the end of the step.
+class Ecology {
+public:
+  struct SpawnRequest {
+    size_t parent;
+    float energy;
+    int type;
+  };
+
+  // With intake the energy source is what each particle took from the resource field;
+  // without it particles share an ambient supply per grid cell. Offspring inherit a mutated
+  // copy of the parent's genome when genomes is given.
+  void step(std::vector<Particle> &particles, const SpatialGrid &grid,
+            const std::vector<float> *intake, GenomePool *genomes, float deltaTime,
+            size_t maxParticles);
+  void reset();
+
+  // Returns false when no dead slot is available
+  bool acquireSlot(size_t &slot);
+  void onParticleCreated(size_t index);
+
+  [[nodiscard]] float getEnergy(size_t index) const {
+    return index < energy.size() ? energy[index] : 0.0F;
+  }
+  [[nodiscard]] size_t getFreeSlotCount() const { return freeSlots.size(); }
+
+private:
+  std::vector<float> energy;
+  std::vector<float> age;
+  std::vector<size_t> freeSlots;
+  std::vector<std::vector<size_t>> killBuffers;
+  std::vector<std::vector<SpawnRequest>> spawnBuffers;
+  std::vector<std::mt19937> generators;
+
+  void ensureCapacity(size_t count, size_t maxParticles);
+  void mergeKills(std::vector<Particle> &particles);
+  size_t mergeSpawns(std::vector<Particle> &particles, GenomePool *genomes, size_t maxParticles);
+};
@@ -0,0 +1,230 @@
+#include "FieldOverlay.h"
+#include <algorithm>
+#include <cmath>
+#include "Graphics/Simulation.h"
+
+FieldOverlay::~FieldOverlay() {
+  if (quadVAO != 0) {
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteTextures(1, &fieldTexture);
+  }
+}
+
+void FieldOverlay::compute(const SpatialGrid &grid, const std::vector<Particle> &particles,
+                           int numSpecies, bool smooth) {
+  width = grid.getWidth();
+  height = grid.getHeight();
+  cellCount = grid.getCellCount();
+  cellSize = grid.getCellSize();
+  origin = grid.getOrigin();
+  layers = std::clamp(numSpecies, 1, MAX_SPECIES) + 1;
+
+  const size_t fieldSize = static_cast<size_t>(layers) * cellCount;
+  density.resize(fieldSize);
+  velocity.resize(fieldSize);
+
+  // Each cell is owned by one iteration, so the accumulation needs no atomics. Velocity holds
+  // momentum until the division at the end so smoothing weights cells by their mass.
+#pragma omp parallel for schedule(static)
+  for (int cell = 0; cell < cellCount; ++cell) {
+    float counts[MAX_SPECIES + 1] = {0.0F};
+    glm::vec2 momentum[MAX_SPECIES + 1] = {};
+
+    for (size_t i : grid.getCell(cell)) {
+      const int layer = std::min(particles[i].getType(), layers - 2) + 1;
+      const glm::vec2 vel = particles[i].getVel();
+      counts[layer] += 1.0F;
+      momentum[layer] += vel;
+      counts[0] += 1.0F;
+      momentum[0] += vel;
+    }
+
+    for (int layer = 0; layer < layers; ++layer) {
+      const size_t idx = (static_cast<size_t>(layer) * cellCount) + cell;
+      density[idx] = counts[layer];
+      velocity[idx] = momentum[layer];
+    }
+  }
+
+  if (smooth && width > 2 && height > 2) {
+    smoothLayers();
+  }
+
+  maxDensity.assign(layers, 0.0F);
+  for (int layer = 0; layer < layers; ++layer) {
+    float layerMax = 0.0F;
+    const size_t base = static_cast<size_t>(layer) * cellCount;
+
+#pragma omp parallel for schedule(static) reduction(max : layerMax)
+    for (int cell = 0; cell < cellCount; ++cell) {
+      const size_t idx = base + cell;
+      const float d = density[idx];
+      velocity[idx] = d > 0.0F ? velocity[idx] / d : glm::vec2(0.0F);
+      layerMax = std::max(layerMax, d);
+    }
+    maxDensity[layer] = layerMax;
+  }
+}
+
+void FieldOverlay::smoothLayers() {
+  // Separable [1 2 1] / 4 blur applied to density and momentum of every layer
+  scratch.resize(static_cast<size_t>(cellCount) * 3);
+
+  for (int layer = 0; layer < layers; ++layer) {
+    float *d = density.data() + (static_cast<size_t>(layer) * cellCount);
+    glm::vec2 *m = velocity.data() + (static_cast<size_t>(layer) * cellCount);
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        const int c = (y * width) + x;
+        const int l = (y * width) + std::max(x - 1, 0);
+        const int r = (y * width) + std::min(x + 1, width - 1);
+        scratch[(c * 3) + 0] = 0.25F * (d[l] + (2.0F * d[c]) + d[r]);
+        const glm::vec2 mc = 0.25F * (m[l] + (2.0F * m[c]) + m[r]);
+        scratch[(c * 3) + 1] = mc.x;
+        scratch[(c * 3) + 2] = mc.y;
+      }
+    }
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+      const int up = std::max(y - 1, 0) * width;
+      const int down = std::min(y + 1, height - 1) * width;
+      for (int x = 0; x < width; ++x) {
+        const int c = (y * width) + x;
+        const int u = up + x;
+        const int b = down + x;
+        d[c] = 0.25F * (scratch[u * 3] + (2.0F * scratch[c * 3]) + scratch[b * 3]);
+        m[c].x = 0.25F * (scratch[(u * 3) + 1] + (2.0F * scratch[(c * 3) + 1]) +
+                          scratch[(b * 3) + 1]);
+        m[c].y = 0.25F * (scratch[(u * 3) + 2] + (2.0F * scratch[(c * 3) + 2]) +
+                          scratch[(b * 3) + 2]);
+      }
+    }
+  }
+}
+
+void FieldOverlay::initializeResources() {
+  heatmapShader = std::make_unique<Shader>("../../../../src/Graphics/shaders/field.vert",
+                                           "../../../../src/Graphics/shaders/field.frag");
+
+  float quadVertices[] = {0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F, 1.0F, 1.0F};
+
+  glGenVertexArrays(1, &quadVAO);
+  glGenBuffers(1, &quadVBO);
+  glBindVertexArray(quadVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+
+  glGenTextures(1, &fieldTexture);
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void FieldOverlay::uploadLayer(int layer) {
+  // Density and mean velocity of one layer packed as RGB; a few hundred texels per frame
+  texels.resize(cellCount);
+  const size_t base = static_cast<size_t>(layer) * cellCount;
+  for (int cell = 0; cell < cellCount; ++cell) {
+    texels[cell] = glm::vec3(density[base + cell], velocity[base + cell]);
+  }
+
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  if (textureWidth != width || textureHeight != height) {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, texels.data());
+    textureWidth = width;
+    textureHeight = height;
+  } else {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGB, GL_FLOAT, texels.data());
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void FieldOverlay::render(Renderer &renderer, int species, int mode) {
+  if (cellCount == 0) {
+    return;
+  }
+  if (quadVAO == 0) {
+    initializeResources();
+  }
+
+  const int layer = std::clamp(species + 1, 0, layers - 1);
+
+  if (mode != 1) {
+    uploadLayer(layer);
+    drawHeatmap(renderer.getProjectionMatrix(), layer);
+  }
+  if (mode != 0) {
+    drawArrows(renderer, layer);
+  }
+}
+
+void FieldOverlay::drawHeatmap(const glm::mat4 &projection, int layer) {
+  heatmapShader->use();
+  heatmapShader->setMat4("projection", projection);
+  heatmapShader->setVec2("gridOrigin", origin);
+  heatmapShader->setVec2("gridExtent", glm::vec2(width, height) * cellSize);
+  heatmapShader->setFloat("invMaxDensity", maxDensity[layer] > 0.0F ? 1.0F / maxDensity[layer]
+                                                                     : 0.0F);
+  heatmapShader->setInt("fieldTexture", 0);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+  glBindVertexArray(quadVAO);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void FieldOverlay::drawArrows(Renderer &renderer, int layer) {
+  const glm::vec3 tint = layer == 0 ? glm::vec3(1.0F)
+                                    : simulation::COLORS[(layer - 1) % simulation::COLORS.size()];
+  const size_t base = static_cast<size_t>(layer) * cellCount;
+  const float invMax = maxDensity[layer] > 0.0F ? 1.0F / maxDensity[layer] : 0.0F;
+
+  // Arrows are normalised so the fastest cell spans half a cell at any speed scale
+  float maxSpeed = 0.0F;
+  for (int cell = 0; cell < cellCount; ++cell) {
+    maxSpeed = std::max(maxSpeed, glm::length(velocity[base + cell]));
+  }
+  const float lengthScale = maxSpeed > 0.0F ? 0.5F * cellSize / maxSpeed : 0.0F;
+
+  arrows.clear();
+  arrows.reserve(static_cast<size_t>(cellCount) * 6);
+  for (int cell = 0; cell < cellCount; ++cell) {
+    const float d = density[base + cell];
+    const glm::vec2 v = velocity[base + cell] * lengthScale;
+    const float len = glm::length(v);
+    if (d <= 0.0F || len < 1.0F) {
+      continue;
+    }
+
+    const glm::vec4 color(tint, 0.35F + (0.65F * std::min(d * invMax, 1.0F)));
+    const glm::vec2 center = origin + (glm::vec2(cell % width, cell / width) + 0.5F) * cellSize;
+    const glm::vec2 tail = center - (v * 0.5F);
+    const glm::vec2 tip = center + (v * 0.5F);
+    const glm::vec2 dir = v / len;
+    const glm::vec2 side(-dir.y, dir.x);
+    const float head = std::min(len * 0.35F, cellSize * 0.15F);
+
+    arrows.push_back({tail, color});
+    arrows.push_back({tip, color});
+    arrows.push_back({tip, color});
+    arrows.push_back({tip - (dir - side * 0.6F) * head, color});
+    arrows.push_back({tip, color});
+    arrows.push_back({tip - (dir + side * 0.6F) * head, color});
+  }
+
+  renderer.drawLines(arrows, 1.5F);
+}
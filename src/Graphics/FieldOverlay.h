@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Graphics/Particle.h"
+#include "Graphics/SpatialGrid.h"
+#include "Graphics/renderer.h"
+#include "Graphics/shader.h"
+
+// Per-species density and mean-velocity fields binned on the neighbour grid. The fields are
+// a by-product of the grid the force pass already built, so computing them costs one sweep
+// over the cells and the upload is a texture the size of the grid, not of the particle count.
+class FieldOverlay {
+public:
+  static constexpr int MAX_SPECIES = 16;
+
+  FieldOverlay() = default;
+  ~FieldOverlay();
+  FieldOverlay(const FieldOverlay &) = delete;
+  FieldOverlay &operator=(const FieldOverlay &) = delete;
+
+  void compute(const SpatialGrid &grid, const std::vector<Particle> &particles, int numSpecies,
+               bool smooth);
+  void render(Renderer &renderer, int species, int mode);
+
+  // Layer 0 aggregates every species, layer s + 1 holds species s
+  [[nodiscard]] float getDensity(int layer, int cell) const {
+    return density[(static_cast<size_t>(layer) * cellCount) + cell];
+  }
+  [[nodiscard]] glm::vec2 getVelocity(int layer, int cell) const {
+    return velocity[(static_cast<size_t>(layer) * cellCount) + cell];
+  }
+
+private:
+  int width = 0;
+  int height = 0;
+  int cellCount = 0;
+  int layers = 0;
+  float cellSize = 1.0F;
+  glm::vec2 origin{0.0F};
+  std::vector<float> density;
+  std::vector<glm::vec2> velocity;
+  std::vector<float> maxDensity;
+  std::vector<float> scratch;
+  std::vector<glm::vec3> texels;
+  std::vector<Vertex2D> arrows;
+
+  std::unique_ptr<Shader> heatmapShader;
+  unsigned int quadVAO = 0;
+  unsigned int quadVBO = 0;
+  unsigned int fieldTexture = 0;
+  int textureWidth = 0;
+  int textureHeight = 0;
+
+  void smoothLayers();
+  void initializeResources();
+  void uploadLayer(int layer);
+  void drawHeatmap(const glm::mat4 &projection, int layer);
+  void drawArrows(Renderer &renderer, int layer);
+};
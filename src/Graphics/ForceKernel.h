@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <omp.h>
+#include <type_traits>
+#include <vector>
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+#include "Graphics/SpatialGrid.h"
+
+// Repulsion range of the force curve, as a fraction of R_MAX, unless a species overrides it
+constexpr float DEFAULT_BETA = 0.3F;
+
+// Force curve shared by every kernel: linear repulsion below beta, then a tent of height a
+// between beta and 1, in units of R_MAX
+inline float forceProfile(float r_norm, float a, float beta) {
+#ifdef __ARM_NEON
+  float32x2_t beta_vec = vdup_n_f32(beta);
+  float32x2_t one_vec = vdup_n_f32(1.0F);
+  float32x2_t input_vec = vdup_n_f32(r_norm);
+  float32x2_t a_vec = vdup_n_f32(a);
+  float32x2_t two_vec = vdup_n_f32(2.0F);
+  float32x2_t repulsion = vsub_f32(vdiv_f32(input_vec, beta_vec), one_vec);
+  float32x2_t inner_term = vsub_f32(vsub_f32(vmul_f32(two_vec, input_vec), one_vec), beta_vec);
+  float32x2_t abs_inner = vabs_f32(inner_term);
+  float32x2_t one_minus_beta = vsub_f32(one_vec, beta_vec);
+  float32x2_t attraction = vmul_f32(a_vec, vsub_f32(one_vec, vdiv_f32(abs_inner, one_minus_beta)));
+  uint32x2_t case1 = vclt_f32(input_vec, beta_vec);
+  uint32x2_t case2 = vand_u32(vcgt_f32(input_vec, beta_vec), vclt_f32(input_vec, one_vec));
+  float32x2_t result = vbsl_f32(case1, repulsion, vbsl_f32(case2, attraction, vdup_n_f32(0.0F)));
+  return vget_lane_f32(result, 0);
+#else // Scalar implementation for non-ARM platforms
+  if (r_norm < beta) {
+    return (r_norm / beta) - 1.0f;
+  } else if (r_norm < 1.0f) {
+    float inner_term = 2.0f * r_norm - 1.0f - beta;
+    return a * (1.0f - (std::abs(inner_term) / (1.0f - beta)));
+  } else {
+    return 0.0f;
+  }
+#endif
+}
+
+// Branch-free form of forceProfile for vector loops, with the per-receiver reciprocals hoisted
+inline float forceProfileSelect(float r_norm, float a, float beta, float invBeta,
+                                float invOneMinusBeta) {
+  const float repulsion = (r_norm * invBeta) - 1.0F;
+  const float attraction = a * (1.0F - (std::abs((2.0F * r_norm) - 1.0F - beta) * invOneMinusBeta));
+  return r_norm < beta ? repulsion : (r_norm < 1.0F ? attraction : 0.0F);
+}
+
+// Interaction models for the force kernels. Each one is a small value type whose call operator
+// returns the attraction a_ij of particle i toward particle j; the kernels are templated on it
+// so the model is resolved at compile time and inlined into the pair loop.
+
+// Species matrix, flattened to a 16x16 table that stays in L1
+struct SpeciesInteraction {
+  static constexpr int MAX_TYPES = 16;
+  const float *matrix;
+  const int *types;
+
+  [[nodiscard]] float operator()(size_t i, size_t j) const {
+    return matrix[(types[i] * MAX_TYPES) + types[j]];
+  }
+};
+
+// Genome traits: how strongly i responds to j is the dot product of i's receptor with j's
+// emitter, evaluated per pair with a 4-wide vector dot
+struct Genome {
+  glm::vec4 emitter;
+  glm::vec4 receptor;
+};
+
+struct GenomeInteraction {
+  const Genome *genomes;
+
+  [[nodiscard]] float operator()(size_t i, size_t j) const {
+    return std::clamp(glm::dot(genomes[i].receptor, genomes[j].emitter), -1.0F, 1.0F);
+  }
+};
+
+// Genomes quantised to clusters; the pair cost is one lookup in a groups x groups matrix
+struct ClusteredInteraction {
+  const uint16_t *groups;
+  const float *matrix;
+  int groupCount;
+
+  [[nodiscard]] float operator()(size_t i, size_t j) const {
+    return matrix[(static_cast<size_t>(groups[i]) * groupCount) + groups[j]];
+  }
+};
+
+// Force curve constants of every species, derived from the beta table once per kernel call so
+// the per-particle cost is a load from this L1-resident table rather than two divisions
+struct SpeciesForceConstants {
+  static constexpr int MAX_TYPES = SpeciesInteraction::MAX_TYPES;
+  alignas(64) float beta[MAX_TYPES];
+  alignas(64) float invBeta[MAX_TYPES];
+  alignas(64) float invOneMinusBeta[MAX_TYPES];
+
+  explicit SpeciesForceConstants(const float *betaTable) {
+    for (int t = 0; t < MAX_TYPES; ++t) {
+      beta[t] = betaTable[t];
+      invBeta[t] = 1.0F / betaTable[t];
+      invOneMinusBeta[t] = 1.0F / (1.0F - betaTable[t]);
+    }
+  }
+};
+
+// Sums the interaction force on every active particle from the 3^D block of grid cells around
+// it. Positions are read from the SoA copy gathered while binning, not from the particles; the
+// receiver's species constants are loaded once and serve every pair it takes part in.
+template <int D, typename Interaction>
+void accumulateGridForces(const SpatialGridND<D> &grid, const std::vector<size_t> &activeParticles,
+                          const glm::vec<D, float> *positions, const int *types, const float *beta,
+                          float rMax, const Interaction &interaction, glm::vec<D, float> *forces) {
+  using Vec = glm::vec<D, float>;
+  const float invRMax = 1.0F / rMax;
+  const float rMaxSqr = rMax * rMax;
+  const SpeciesForceConstants constants(beta);
+
+#pragma omp parallel for schedule(static)
+  for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+    const size_t i = activeParticles[idx];
+    Vec totalForce(0.0F);
+    const Vec pos_i = positions[i];
+    const int type_i = types[i];
+    const float beta_i = constants.beta[type_i];
+    const float invBeta_i = constants.invBeta[type_i];
+    const float invOneMinusBeta_i = constants.invOneMinusBeta[type_i];
+
+    grid.forEachNeighbourCell(grid.getParticleCell(i), [&](int cell) {
+      for (size_t j : grid.getCell(cell)) {
+        const Vec dist = positions[j] - pos_i;
+        const float distSqr = glm::dot(dist, dist);
+        if (i == j || distSqr < 2.5F || distSqr >= rMaxSqr) {
+          continue;
+        }
+
+        const float invDist = 1.0F / std::sqrt(distSqr);
+        const float normDist = distSqr * invDist * invRMax;
+        const float forceMag =
+            forceProfileSelect(normDist, interaction(i, j), beta_i, invBeta_i, invOneMinusBeta_i);
+        totalForce += dist * (forceMag * invDist);
+      }
+    });
+    forces[i] = totalForce * rMax;
+  }
+}
+
+// All-pairs kernel for boxes too small for the grid to pay off
+constexpr size_t PAIR_TILE = 8;           // receivers sharing each streamed block of partners
+constexpr size_t PAIR_BLOCK = 512;        // partners per block, so a block's SoA stays in L1
+constexpr size_t PAIR_PARALLEL_MIN = 256; // below this the fork costs more than the pairs
+
+// SoA copy of the listed particles plus per-thread accumulators for the mirrored half of each
+// pair; owned by the caller so steady-state steps do not allocate
+template <int D> struct PairForceScratch {
+  std::vector<float> coords[D];
+  std::vector<int> species;
+  std::vector<float> beta;
+  std::vector<float> invBeta;
+  std::vector<float> invOneMinusBeta;
+  std::vector<std::vector<float>> threadForces;
+};
+
+// Whether the all-pairs kernel beats the grid on a box of cellTotal R_MAX-sized cells. The grid
+// visits about n^2 3^D / cellTotal pairs with a branch each, the pair kernel n^2 / 2 branch-free
+// ones, so the crossover is set by the box size rather than by n. Measured at break-even: 6x6
+// cells in 2D for every n from 400 to 2400 (twice as fast at 4x4, the grid wins from 8x8 and at
+// the GUI's default box), 4x4x4 in 3D at n = 3000 (2.5 times as fast at 3x3x3). Below a few
+// hundred particles either kernel costs microseconds.
+template <int D> bool pairKernelPays(int cellTotal) {
+  constexpr int BREAK_EVEN_CELLS = D == 2 ? 36 : 64;
+  return cellTotal < BREAK_EVEN_CELLS;
+}
+
+// Pair loop of accumulatePairForces for receiver i against partners [j0, j1), given both
+// directed attractions of each pair; the cutoff is a mask so the loop vectorises over partners
+template <int D>
+inline void pairForces(const float *const *coords, size_t i, size_t j0, size_t j1,
+                       const float *__restrict toward, const float *__restrict from,
+                       const float *__restrict beta, const float *__restrict invBeta,
+                       const float *__restrict invOneMinusBeta, float rMaxSqr, float invRMax,
+                       size_t stride, float *force_i, float *__restrict acc) {
+  const float *__restrict x = coords[0] + j0;
+  const float *__restrict y = coords[1] + j0;
+  const float *__restrict z = D == 3 ? coords[2] + j0 : x;
+  const float x_i = coords[0][i];
+  const float y_i = coords[1][i];
+  const float z_i = D == 3 ? coords[2][i] : 0.0F;
+  const float beta_i = beta[i];
+  const float invBeta_i = invBeta[i];
+  const float invOneMinusBeta_i = invOneMinusBeta[i];
+  beta += j0;
+  invBeta += j0;
+  invOneMinusBeta += j0;
+  float *__restrict accX = acc + j0;
+  float *__restrict accY = acc + stride + j0;
+  float *__restrict accZ = D == 3 ? acc + (2 * stride) + j0 : accX;
+
+  // Plain scalar sums so the vectoriser sees reductions; the third stays zero in 2D
+  float sumX = 0.0F;
+  float sumY = 0.0F;
+  float sumZ = 0.0F;
+  const size_t count = j1 - j0;
+#pragma omp simd reduction(+ : sumX, sumY, sumZ)
+  for (size_t j = 0; j < count; ++j) {
+    const float dx = x[j] - x_i;
+    const float dy = y[j] - y_i;
+    const float dz = D == 3 ? z[j] - z_i : 0.0F;
+    const float distSqr = (dx * dx) + (dy * dy) + (dz * dz);
+    const bool inRange = distSqr >= 2.5F && distSqr < rMaxSqr;
+    const float invDist = 1.0F / std::sqrt(std::max(distSqr, 2.5F));
+    const float normDist = distSqr * invDist * invRMax;
+
+    const float toward_j =
+        forceProfileSelect(normDist, toward[j], beta_i, invBeta_i, invOneMinusBeta_i);
+    const float toward_i =
+        forceProfileSelect(normDist, from[j], beta[j], invBeta[j], invOneMinusBeta[j]);
+    const float scale_i = inRange ? toward_j * invDist : 0.0F;
+    const float scale_j = inRange ? toward_i * invDist : 0.0F;
+    sumX += dx * scale_i;
+    sumY += dy * scale_i;
+    sumZ += dz * scale_i;
+    accX[j] -= dx * scale_j;
+    accY[j] -= dy * scale_j;
+    if constexpr (D == 3) {
+      accZ[j] -= dz * scale_j;
+    }
+  }
+
+  force_i[0] += sumX;
+  force_i[1] += sumY;
+  if constexpr (D == 3) {
+    force_i[2] += sumZ;
+  }
+}
+
+// Sums the interaction force on every listed particle from every other listed particle. Each
+// unordered pair is visited once: the distance and its square root are shared, and the two
+// directed forces (a_ij with i's beta, a_ji with j's) go to both ends. Receivers are taken in
+// tiles of PAIR_TILE, each streaming the later particles in L1-sized blocks that the whole tile
+// reuses; the cutoff is a mask, so the j loop has no branches and vectorises over partners. The
+// mirrored forces land in per-thread arrays that are summed at the end, so tiles can run on
+// any thread.
+template <int D, typename Interaction>
+void accumulatePairForces(PairForceScratch<D> &scratch, const std::vector<size_t> &particles,
+                          const glm::vec<D, float> *positions, const int *types, const float *beta,
+                          float rMax, const Interaction &interaction, glm::vec<D, float> *forces) {
+  const size_t m = particles.size();
+  if (m == 0) {
+    return;
+  }
+  const float invRMax = 1.0F / rMax;
+  const float rMaxSqr = rMax * rMax;
+
+  for (int d = 0; d < D; ++d) {
+    scratch.coords[d].resize(m);
+  }
+  scratch.species.resize(m);
+  scratch.beta.resize(m);
+  scratch.invBeta.resize(m);
+  scratch.invOneMinusBeta.resize(m);
+  const SpeciesForceConstants constants(beta);
+  for (size_t k = 0; k < m; ++k) {
+    const size_t p = particles[k];
+    for (int d = 0; d < D; ++d) {
+      scratch.coords[d][k] = positions[p][d];
+    }
+    const int t = types[p];
+    scratch.species[k] = t;
+    scratch.beta[k] = constants.beta[t];
+    scratch.invBeta[k] = constants.invBeta[t];
+    scratch.invOneMinusBeta[k] = constants.invOneMinusBeta[t];
+  }
+
+  const int threads = m >= PAIR_PARALLEL_MIN ? omp_get_max_threads() : 1;
+  scratch.threadForces.resize(threads);
+  for (std::vector<float> &acc : scratch.threadForces) {
+    acc.assign(D * m, 0.0F);
+  }
+
+  const float *coords[D];
+  for (int d = 0; d < D; ++d) {
+    coords[d] = scratch.coords[d].data();
+  }
+  const int *speciesOf = scratch.species.data();
+  const float *betaOf = scratch.beta.data();
+  const float *invBetaOf = scratch.invBeta.data();
+  const float *invOneMinusBetaOf = scratch.invOneMinusBeta.data();
+  const size_t *index = particles.data();
+
+  // Receiver i against partners [j0, j1): i's force accumulates in force_i, the mirrored forces
+  // in the thread's array. The attractions are looked up first into block-sized buffers, so the
+  // arithmetic loop reads only contiguous floats and vectorises whatever the model.
+  const auto pairRow = [&](size_t i, size_t j0, size_t j1, float *force_i, float *acc) {
+    const size_t p = index[i];
+    float toward[PAIR_BLOCK];
+    float from[PAIR_BLOCK];
+    if constexpr (std::is_same_v<Interaction, SpeciesInteraction>) {
+      // A species matrix reduces to i's row and column, indexed by the partner's species
+      constexpr int TYPES = SpeciesInteraction::MAX_TYPES;
+      const float *row = interaction.matrix + (speciesOf[i] * TYPES);
+      const float *column = interaction.matrix + speciesOf[i];
+      for (size_t j = j0; j < j1; ++j) {
+        toward[j - j0] = row[speciesOf[j]];
+        from[j - j0] = column[speciesOf[j] * TYPES];
+      }
+    } else {
+      for (size_t j = j0; j < j1; ++j) {
+        toward[j - j0] = interaction(p, index[j]);
+        from[j - j0] = interaction(index[j], p);
+      }
+    }
+    pairForces<D>(coords, i, j0, j1, toward, from, betaOf, invBetaOf, invOneMinusBetaOf, rMaxSqr,
+                  invRMax, m, force_i, acc);
+  };
+
+  // Tiles near the start pair with more particles, so they are handed out dynamically
+  const int tiles = static_cast<int>((m + PAIR_TILE - 1) / PAIR_TILE);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads) if (threads > 1)
+  for (int t = 0; t < tiles; ++t) {
+    float *acc = scratch.threadForces[omp_get_thread_num()].data();
+    const size_t i0 = static_cast<size_t>(t) * PAIR_TILE;
+    const size_t i1 = std::min(i0 + PAIR_TILE, m);
+    float force[PAIR_TILE][D] = {};
+
+    for (size_t i = i0; i < i1; ++i) {
+      pairRow(i, i + 1, i1, force[i - i0], acc);
+    }
+    // Each block of later particles is reused by the whole tile while it is in L1
+    for (size_t j0 = i1; j0 < m; j0 += PAIR_BLOCK) {
+      const size_t j1 = std::min(j0 + PAIR_BLOCK, m);
+      for (size_t i = i0; i < i1; ++i) {
+        pairRow(i, j0, j1, force[i - i0], acc);
+      }
+    }
+
+    for (size_t i = i0; i < i1; ++i) {
+      for (int d = 0; d < D; ++d) {
+        acc[(d * m) + i] += force[i - i0][d];
+      }
+    }
+  }
+
+#pragma omp parallel for schedule(static) num_threads(threads) if (threads > 1)
+  for (int k = 0; k < static_cast<int>(m); ++k) {
+    glm::vec<D, float> total(0.0F);
+    for (const std::vector<float> &acc : scratch.threadForces) {
+      for (int d = 0; d < D; ++d) {
+        total[d] += acc[(d * m) + k];
+      }
+    }
+    forces[index[k]] = total * rMax;
+  }
+}
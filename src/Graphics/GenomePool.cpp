@@ -0,0 +1,170 @@
+#include "GenomePool.h"
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+
+namespace {
+float genomeDistanceSqr(const Genome &a, const Genome &b) {
+  const glm::vec4 de = a.emitter - b.emitter;
+  const glm::vec4 dr = a.receptor - b.receptor;
+  return glm::dot(de, de) + glm::dot(dr, dr);
+}
+} // namespace
+
+size_t GenomePool::resize(size_t count) {
+  const size_t previous = genomes.size();
+  if (count > previous) {
+    genomes.resize(count);
+    groups.resize(count);
+    for (size_t i = previous; i < count; ++i) {
+      randomize(i, generator);
+      // Join the nearest existing group rather than group 0 until the next pass; offspring
+      // then take their parent's group in inherit()
+      groups[i] = static_cast<uint16_t>(nearestCentroid(genomes[i]));
+    }
+  } else if (count < previous) {
+    genomes.resize(count);
+    groups.resize(count);
+  }
+  return previous;
+}
+
+void GenomePool::randomize(size_t index, std::mt19937 &gen) {
+  // Components in [-0.5, 0.5] keep the dot product of two random genomes inside [-1, 1]
+  std::uniform_real_distribution<float> trait(-0.5F, 0.5F);
+  Genome &g = genomes[index];
+  g.emitter = glm::vec4(trait(gen), trait(gen), trait(gen), trait(gen));
+  g.receptor = glm::vec4(trait(gen), trait(gen), trait(gen), trait(gen));
+}
+
+void GenomePool::inherit(size_t child, size_t parent, float mutation, std::mt19937 &gen) {
+  std::normal_distribution<float> noise(0.0F, mutation);
+  const Genome &p = genomes[parent];
+  Genome &c = genomes[child];
+  c.emitter = glm::clamp(p.emitter + glm::vec4(noise(gen), noise(gen), noise(gen), noise(gen)),
+                         -1.0F, 1.0F);
+  c.receptor = glm::clamp(
+      p.receptor + glm::vec4(noise(gen), noise(gen), noise(gen), noise(gen)), -1.0F, 1.0F);
+  groups[child] = groups[parent];
+}
+
+void GenomePool::compact(const std::vector<Particle> &particles) {
+  // Mirrors the remove_if compaction of the particle vector so indices stay aligned
+  size_t out = 0;
+  for (size_t i = 0; i < particles.size() && i < genomes.size(); ++i) {
+    if (particles[i].isActive()) {
+      genomes[out] = genomes[i];
+      groups[out] = groups[i];
+      ++out;
+    }
+  }
+  genomes.resize(out);
+  groups.resize(out);
+}
+
+void GenomePool::clear() {
+  genomes.clear();
+  groups.clear();
+  centroids.clear();
+  groupMatrix.clear();
+  groupCount = 1;
+}
+
+glm::vec3 GenomePool::colorOf(size_t index) const {
+  const glm::vec3 e = glm::vec3(genomes[index].emitter);
+  const float len = glm::length(e);
+  return len > 0.0F ? glm::vec3(0.55F) + (0.45F * e / len) : glm::vec3(0.8F);
+}
+
+void GenomePool::cluster(const std::vector<Particle> &particles, int requestedGroups,
+                         int iterations) {
+  std::vector<size_t> activeParticles;
+  activeParticles.reserve(genomes.size());
+  for (size_t i = 0; i < particles.size() && i < genomes.size(); ++i) {
+    if (particles[i].isActive()) {
+      activeParticles.push_back(i);
+    }
+  }
+  if (activeParticles.empty()) {
+    return;
+  }
+
+  const int k = std::clamp(requestedGroups, 1,
+                           std::min(MAX_GROUPS, static_cast<int>(activeParticles.size())));
+
+  // Warm start from the previous centroids so periodic reclustering converges in a pass or two
+  if (static_cast<int>(centroids.size()) != k) {
+    centroids.resize(k);
+    std::uniform_int_distribution<size_t> pick(0, activeParticles.size() - 1);
+    for (auto &centroid : centroids) {
+      centroid = genomes[activeParticles[pick(generator)]];
+    }
+  }
+  groupCount = k;
+
+  const int threads = omp_get_max_threads();
+  std::vector<Genome> partialSums(static_cast<size_t>(threads) * k);
+  std::vector<int> partialCounts(static_cast<size_t>(threads) * k);
+
+  for (int iteration = 0; iteration < iterations; ++iteration) {
+    std::fill(partialSums.begin(), partialSums.end(), Genome{glm::vec4(0.0F), glm::vec4(0.0F)});
+    std::fill(partialCounts.begin(), partialCounts.end(), 0);
+
+#pragma omp parallel
+    {
+      const int thread = omp_get_thread_num();
+      Genome *sums = partialSums.data() + (static_cast<size_t>(thread) * k);
+      int *counts = partialCounts.data() + (static_cast<size_t>(thread) * k);
+
+#pragma omp for schedule(static)
+      for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
+        const size_t i = activeParticles[idx];
+        const int best = nearestCentroid(genomes[i]);
+        groups[i] = static_cast<uint16_t>(best);
+        sums[best].emitter += genomes[i].emitter;
+        sums[best].receptor += genomes[i].receptor;
+        counts[best]++;
+      }
+    }
+
+    for (int c = 0; c < k; ++c) {
+      Genome sum{glm::vec4(0.0F), glm::vec4(0.0F)};
+      int count = 0;
+      for (int t = 0; t < threads; ++t) {
+        sum.emitter += partialSums[(static_cast<size_t>(t) * k) + c].emitter;
+        sum.receptor += partialSums[(static_cast<size_t>(t) * k) + c].receptor;
+        count += partialCounts[(static_cast<size_t>(t) * k) + c];
+      }
+      // Empty clusters keep their old centroid and pick members up on a later pass
+      if (count > 0) {
+        const float inv = 1.0F / static_cast<float>(count);
+        centroids[c] = {sum.emitter * inv, sum.receptor * inv};
+      }
+    }
+  }
+
+  rebuildGroupMatrix();
+}
+
+int GenomePool::nearestCentroid(const Genome &genome) const {
+  int best = 0;
+  float bestDist = std::numeric_limits<float>::max();
+  for (int c = 0; c < static_cast<int>(centroids.size()); ++c) {
+    const float d = genomeDistanceSqr(genome, centroids[c]);
+    if (d < bestDist) {
+      bestDist = d;
+      best = c;
+    }
+  }
+  return best;
+}
+
+void GenomePool::rebuildGroupMatrix() {
+  groupMatrix.resize(static_cast<size_t>(groupCount) * groupCount);
+  for (int a = 0; a < groupCount; ++a) {
+    for (int b = 0; b < groupCount; ++b) {
+      groupMatrix[(static_cast<size_t>(a) * groupCount) + b] =
+          std::clamp(glm::dot(centroids[a].receptor, centroids[b].emitter), -1.0F, 1.0F);
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Graphics/ForceKernel.h"
+#include "Graphics/Particle.h"
+
+// Per-particle genomes, indexed like the particle vector. In clustered mode the genomes are
+// periodically grouped with k-means and the kernels read a small group matrix built from the
+// centroids, which keeps the per-pair cost at one lookup for thousands of effective species.
+class GenomePool {
+public:
+  static constexpr int MAX_GROUPS = 256;
+
+  // New entries get random genomes in the nearest current group; returns the previous size so
+  // callers can recolour them
+  size_t resize(size_t count);
+  void randomize(size_t index, std::mt19937 &gen);
+  void inherit(size_t child, size_t parent, float mutation, std::mt19937 &gen);
+  void compact(const std::vector<Particle> &particles);
+  void clear();
+
+  void cluster(const std::vector<Particle> &particles, int groupCount, int iterations);
+
+  [[nodiscard]] glm::vec3 colorOf(size_t index) const;
+
+  [[nodiscard]] GenomeInteraction direct() const { return {genomes.data()}; }
+  [[nodiscard]] ClusteredInteraction clustered() const {
+    return {groups.data(), groupMatrix.data(), groupCount};
+  }
+  [[nodiscard]] int getGroupCount() const { return groupCount; }
+
+private:
+  std::vector<Genome> genomes;
+  std::vector<uint16_t> groups;
+  std::vector<Genome> centroids;
+  std::vector<float> groupMatrix;
+  int groupCount = 1;
+  std::mt19937 generator{std::random_device{}()};
+
+  // Group whose centroid is closest, 0 before the first clustering pass
+  [[nodiscard]] int nearestCentroid(const Genome &genome) const;
+  void rebuildGroupMatrix();
+};
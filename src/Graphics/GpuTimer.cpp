@@ -0,0 +1,55 @@
+#include "GpuTimer.h"
+
+namespace {
+// Weight of the newest sample
+constexpr float SMOOTHING = 0.1F;
+} // namespace
+
+GpuTimer::GpuTimer() {
+  glGenQueries(QUERY_COUNT, starts);
+  glGenQueries(QUERY_COUNT, ends);
+}
+
+GpuTimer::~GpuTimer() {
+  glDeleteQueries(QUERY_COUNT, ends);
+  glDeleteQueries(QUERY_COUNT, starts);
+}
+
+void GpuTimer::collect() {
+  for (int q = 0; q < QUERY_COUNT; ++q) {
+    if (!pending[q]) {
+      continue;
+    }
+    // The end stamp lands last, so once it is available so is the start
+    GLint available = 0;
+    glGetQueryObjectiv(ends[q], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == 0) {
+      continue;
+    }
+    GLuint64 start = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(starts[q], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(ends[q], GL_QUERY_RESULT, &end);
+    pending[q] = false;
+    const float sample = end > start ? static_cast<float>(end - start) * 1e-6F : 0.0F;
+    ms = ms == 0.0F ? sample : ms + (SMOOTHING * (sample - ms));
+  }
+}
+
+void GpuTimer::begin() {
+  collect();
+  timing = !pending[index];
+  if (timing) {
+    glQueryCounter(starts[index], GL_TIMESTAMP);
+  }
+}
+
+void GpuTimer::end() {
+  if (!timing) {
+    return;
+  }
+  glQueryCounter(ends[index], GL_TIMESTAMP);
+  pending[index] = true;
+  index = (index + 1) % QUERY_COUNT;
+  timing = false;
+}
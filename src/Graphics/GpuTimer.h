@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// GPU time between begin() and end(), from timestamp queries that are read a few frames late so
+// the CPU never waits on them. Timestamps rather than GL_TIME_ELAPSED, so timers may nest.
+class GpuTimer {
+public:
+  GpuTimer();
+  ~GpuTimer();
+  GpuTimer(const GpuTimer &) = delete;
+  GpuTimer &operator=(const GpuTimer &) = delete;
+
+  // A query pair still in flight is skipped rather than waited on; that span goes untimed
+  void begin();
+  void end();
+
+  // Smoothed milliseconds, 0 until the first result arrives
+  [[nodiscard]] float getMs() const { return ms; }
+
+private:
+  static constexpr int QUERY_COUNT = 3;
+
+  GLuint starts[QUERY_COUNT] = {};
+  GLuint ends[QUERY_COUNT] = {};
+  bool pending[QUERY_COUNT] = {};
+  int index = 0;
+  bool timing = false; // a span is open between begin() and end()
+  float ms = 0.0F;
+
+  void collect();
+};
@@ -0,0 +1,119 @@
+#include "ImageWriter.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Largest stored deflate block
+constexpr size_t MAX_STORED_BLOCK = 65535;
+
+const std::array<uint32_t, 256> &crcTable() {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> entries{};
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1U) != 0 ? 0xedb88320U ^ (c >> 1) : c >> 1;
+      }
+      entries[n] = c;
+    }
+    return entries;
+  }();
+  return table;
+}
+
+uint32_t crc(const uint8_t *data, size_t size, uint32_t running = 0xffffffffU) {
+  const std::array<uint32_t, 256> &table = crcTable();
+  for (size_t i = 0; i < size; ++i) {
+    running = table[(running ^ data[i]) & 0xffU] ^ (running >> 8);
+  }
+  return running;
+}
+
+void putBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeChunk(std::ostream &out, const char *type, const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> header;
+  putBigEndian(header, static_cast<uint32_t>(data.size()));
+  header.insert(header.end(), type, type + 4);
+  const uint32_t checksum =
+      crc(data.data(), data.size(), crc(header.data() + 4, 4)) ^ 0xffffffffU;
+  std::vector<uint8_t> trailer;
+  putBigEndian(trailer, checksum);
+
+  out.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(8));
+  out.write(reinterpret_cast<const char *>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+  out.write(reinterpret_cast<const char *>(trailer.data()), static_cast<std::streamsize>(4));
+}
+} // namespace
+
+void writePng(const std::string &path, const uint8_t *rgb, int width, int height) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    throw std::runtime_error("Cannot open " + path + " for writing");
+  }
+
+  // Scanlines with filter type 0 in front of every row
+  const size_t rowBytes = static_cast<size_t>(width) * 3;
+  std::vector<uint8_t> raw;
+  raw.reserve((rowBytes + 1) * height);
+  for (int y = 0; y < height; ++y) {
+    raw.push_back(0);
+    raw.insert(raw.end(), rgb + (y * rowBytes), rgb + ((y + 1) * rowBytes));
+  }
+
+  // zlib stream of stored blocks, closed by the Adler-32 of the scanlines
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  zlib.reserve(raw.size() + (raw.size() / MAX_STORED_BLOCK * 5) + 16);
+  uint32_t adlerA = 1;
+  uint32_t adlerB = 0;
+  for (size_t offset = 0;; offset += MAX_STORED_BLOCK) {
+    const size_t size = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+    const bool last = offset + size >= raw.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back(static_cast<uint8_t>(size));
+    zlib.push_back(static_cast<uint8_t>(size >> 8));
+    zlib.push_back(static_cast<uint8_t>(~size));
+    zlib.push_back(static_cast<uint8_t>(~size >> 8));
+    zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset),
+                raw.begin() + static_cast<std::ptrdiff_t>(offset + size));
+    for (size_t i = offset; i < offset + size; ++i) {
+      adlerA = (adlerA + raw[i]) % 65521U;
+      adlerB = (adlerB + adlerA) % 65521U;
+    }
+    if (last) {
+      break;
+    }
+  }
+  putBigEndian(zlib, (adlerB << 16) | adlerA);
+
+  std::vector<uint8_t> header;
+  putBigEndian(header, static_cast<uint32_t>(width));
+  putBigEndian(header, static_cast<uint32_t>(height));
+  header.insert(header.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, deflate, no interlace
+
+  static constexpr uint8_t SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  out.write(reinterpret_cast<const char *>(SIGNATURE), sizeof(SIGNATURE));
+  writeChunk(out, "IHDR", header);
+  writeChunk(out, "IDAT", zlib);
+  writeChunk(out, "IEND", {});
+  if (!out) {
+    throw std::runtime_error("Failed writing " + path);
+  }
+}
+
+void writeRawFrame(std::ostream &out, const uint8_t *rgb, int width, int height) {
+  out.write(reinterpret_cast<const char *>(rgb),
+            static_cast<std::streamsize>(static_cast<size_t>(width) * height * 3));
+  if (!out) {
+    throw std::runtime_error("Failed writing a raw frame");
+  }
+}
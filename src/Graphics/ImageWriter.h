@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Writers for 8-bit RGB images, top row first, with no image library behind them. PNGs are
+// stored without compression: they open anywhere, but are about as large as the raw pixels.
+// Raw frames are the bare pixels, the rgb24 input ffmpeg reads from a pipe.
+void writePng(const std::string &path, const uint8_t *rgb, int width, int height);
+void writeRawFrame(std::ostream &out, const uint8_t *rgb, int width, int height);
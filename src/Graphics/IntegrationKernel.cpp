@@ -0,0 +1,201 @@
+#include "IntegrationKernel.h"
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+void integrateScalar(float *positions, float *velocities, const float *forces, size_t count,
+                     int components, const float *halfExtent, float deltaTime, float friction,
+                     float bounce) {
+  for (size_t i = 0; i < count; ++i) {
+    for (int d = 0; d < components; ++d) {
+      const size_t k = (i * components) + d;
+      const float half = halfExtent[d];
+      float vel = velocities[k];
+      if (forces != nullptr) {
+        vel += forces[k] * deltaTime;
+      }
+      vel *= friction;
+      float pos = positions[k] + (vel * deltaTime);
+      if (pos > half || pos < -half) {
+        pos = pos > half ? half : -half;
+        vel *= -bounce;
+      }
+      positions[k] = pos;
+      velocities[k] = vel;
+    }
+  }
+}
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__ARM_NEON)
+
+// Lane l of pattern register r holds the bound of float (r * lanes + l) of a block; a block of
+// `components` registers covers exactly `lanes` particles, so the pattern repeats every block
+template <size_t LANES> struct BoundPattern {
+  alignas(64) float upper[3][LANES];
+  alignas(64) float lower[3][LANES];
+
+  BoundPattern(const float *halfExtent, int components) {
+    for (int r = 0; r < components; ++r) {
+      for (size_t l = 0; l < LANES; ++l) {
+        upper[r][l] = halfExtent[((r * LANES) + l) % components];
+        lower[r][l] = -upper[r][l];
+      }
+    }
+  }
+};
+
+#endif
+
+#if defined(__AVX512F__)
+
+// Returns the number of particles integrated, a multiple of the vector width
+size_t integrateVector(float *positions, float *velocities, const float *forces, size_t count,
+                       int components, const float *halfExtent, float deltaTime, float friction,
+                       float bounce) {
+  constexpr size_t LANES = 16;
+  const BoundPattern<LANES> pattern(halfExtent, components);
+  const __m512 dt = _mm512_set1_ps(deltaTime);
+  const __m512 keep = _mm512_set1_ps(friction);
+  const __m512 reflect = _mm512_set1_ps(-bounce);
+
+  const size_t blocks = count / LANES;
+  for (size_t b = 0; b < blocks; ++b) {
+    for (int r = 0; r < components; ++r) {
+      const size_t k = ((b * components) + r) * LANES;
+      const __m512 upper = _mm512_load_ps(pattern.upper[r]);
+      const __m512 lower = _mm512_load_ps(pattern.lower[r]);
+
+      __m512 vel = _mm512_loadu_ps(velocities + k);
+      if (forces != nullptr) {
+        vel = _mm512_fmadd_ps(_mm512_loadu_ps(forces + k), dt, vel);
+      }
+      vel = _mm512_mul_ps(vel, keep);
+      __m512 pos = _mm512_fmadd_ps(vel, dt, _mm512_loadu_ps(positions + k));
+
+      const __mmask16 out = _mm512_cmp_ps_mask(pos, upper, _CMP_GT_OQ) |
+                            _mm512_cmp_ps_mask(pos, lower, _CMP_LT_OQ);
+      pos = _mm512_min_ps(_mm512_max_ps(pos, lower), upper);
+      vel = _mm512_mask_mul_ps(vel, out, vel, reflect);
+
+      _mm512_storeu_ps(positions + k, pos);
+      _mm512_storeu_ps(velocities + k, vel);
+    }
+  }
+  return blocks * LANES;
+}
+
+#elif defined(__AVX2__)
+
+inline __m256 multiplyAdd(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+size_t integrateVector(float *positions, float *velocities, const float *forces, size_t count,
+                       int components, const float *halfExtent, float deltaTime, float friction,
+                       float bounce) {
+  constexpr size_t LANES = 8;
+  const BoundPattern<LANES> pattern(halfExtent, components);
+  const __m256 dt = _mm256_set1_ps(deltaTime);
+  const __m256 keep = _mm256_set1_ps(friction);
+  const __m256 reflect = _mm256_set1_ps(-bounce);
+
+  const size_t blocks = count / LANES;
+  for (size_t b = 0; b < blocks; ++b) {
+    for (int r = 0; r < components; ++r) {
+      const size_t k = ((b * components) + r) * LANES;
+      const __m256 upper = _mm256_load_ps(pattern.upper[r]);
+      const __m256 lower = _mm256_load_ps(pattern.lower[r]);
+
+      __m256 vel = _mm256_loadu_ps(velocities + k);
+      if (forces != nullptr) {
+        vel = multiplyAdd(_mm256_loadu_ps(forces + k), dt, vel);
+      }
+      vel = _mm256_mul_ps(vel, keep);
+      __m256 pos = multiplyAdd(vel, dt, _mm256_loadu_ps(positions + k));
+
+      const __m256 out = _mm256_or_ps(_mm256_cmp_ps(pos, upper, _CMP_GT_OQ),
+                                      _mm256_cmp_ps(pos, lower, _CMP_LT_OQ));
+      pos = _mm256_min_ps(_mm256_max_ps(pos, lower), upper);
+      vel = _mm256_blendv_ps(vel, _mm256_mul_ps(vel, reflect), out);
+
+      _mm256_storeu_ps(positions + k, pos);
+      _mm256_storeu_ps(velocities + k, vel);
+    }
+  }
+  return blocks * LANES;
+}
+
+#elif defined(__ARM_NEON)
+
+inline float32x4_t multiplyAdd(float32x4_t a, float32x4_t b, float32x4_t c) {
+#ifdef __ARM_FEATURE_FMA
+  return vfmaq_f32(c, a, b);
+#else
+  return vmlaq_f32(c, a, b);
+#endif
+}
+
+size_t integrateVector(float *positions, float *velocities, const float *forces, size_t count,
+                       int components, const float *halfExtent, float deltaTime, float friction,
+                       float bounce) {
+  constexpr size_t LANES = 4;
+  const BoundPattern<LANES> pattern(halfExtent, components);
+  const float32x4_t dt = vdupq_n_f32(deltaTime);
+  const float32x4_t keep = vdupq_n_f32(friction);
+  const float32x4_t reflect = vdupq_n_f32(-bounce);
+
+  const size_t blocks = count / LANES;
+  for (size_t b = 0; b < blocks; ++b) {
+    for (int r = 0; r < components; ++r) {
+      const size_t k = ((b * components) + r) * LANES;
+      const float32x4_t upper = vld1q_f32(pattern.upper[r]);
+      const float32x4_t lower = vld1q_f32(pattern.lower[r]);
+
+      float32x4_t vel = vld1q_f32(velocities + k);
+      if (forces != nullptr) {
+        vel = multiplyAdd(vld1q_f32(forces + k), dt, vel);
+      }
+      vel = vmulq_f32(vel, keep);
+      float32x4_t pos = multiplyAdd(vel, dt, vld1q_f32(positions + k));
+
+      const uint32x4_t out = vorrq_u32(vcgtq_f32(pos, upper), vcltq_f32(pos, lower));
+      pos = vminq_f32(vmaxq_f32(pos, lower), upper);
+      vel = vbslq_f32(out, vmulq_f32(vel, reflect), vel);
+
+      vst1q_f32(positions + k, pos);
+      vst1q_f32(velocities + k, vel);
+    }
+  }
+  return blocks * LANES;
+}
+
+#else
+
+size_t integrateVector(float * /*positions*/, float * /*velocities*/, const float * /*forces*/,
+                       size_t /*count*/, int /*components*/, const float * /*halfExtent*/,
+                       float /*deltaTime*/, float /*friction*/, float /*bounce*/) {
+  return 0;
+}
+
+#endif
+
+} // namespace
+
+void integrateArrays(float *positions, float *velocities, const float *forces, size_t count,
+                     int components, const float *halfExtent, float deltaTime, float friction,
+                     float bounce) {
+  const size_t done = integrateVector(positions, velocities, forces, count, components,
+                                      halfExtent, deltaTime, friction, bounce);
+  const size_t offset = done * components;
+  integrateScalar(positions + offset, velocities + offset,
+                  forces != nullptr ? forces + offset : nullptr, count - done, components,
+                  halfExtent, deltaTime, friction, bounce);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+// Semi-implicit Euler step with wall reflection over contiguous interleaved arrays: count
+// particles of `components` floats each (2 or 3). Per component d:
+//   v = (v + f * dt) * friction,  p += v * dt,
+//   and past +-halfExtent[d] p is clamped to the wall and v scaled by -bounce.
+// A half extent of FLT_MAX disables that wall without a branch in the loop. forces may be null.
+// The arrays are walked as flat float streams with the bounds laid out as a repeating lane
+// pattern, so AVX-512, AVX2 and NEON builds run full-width vectors regardless of D and the pass
+// is bound by memory bandwidth.
+void integrateArrays(float *positions, float *velocities, const float *forces, size_t count,
+                     int components, const float *halfExtent, float deltaTime, float friction,
+                     float bounce);
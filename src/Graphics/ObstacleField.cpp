@@ -0,0 +1,439 @@
+#include "ObstacleField.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <glm/gtc/constants.hpp>
+#include "Graphics/Simulation.h"
+
+namespace {
+constexpr float FAR_AWAY = 1.0e6F;
+constexpr int CIRCLE_SEGMENTS = 32;
+
+float segmentDistance(const glm::vec2 &p, const glm::vec2 &a, const glm::vec2 &b) {
+  const glm::vec2 ab = b - a;
+  const float t =
+      std::clamp(glm::dot(p - a, ab) / std::max(glm::dot(ab, ab), 1e-12F), 0.0F, 1.0F);
+  return glm::length(p - (a + (ab * t)));
+}
+
+float cross(const glm::vec2 &a, const glm::vec2 &b) { return (a.x * b.y) - (a.y * b.x); }
+
+// Ear clipping for simple polygons of either winding; only runs when the mesh is rebuilt
+void triangulate(const std::vector<glm::vec2> &polygon, const glm::vec4 &color,
+                 std::vector<Vertex2D> &out) {
+  std::vector<int> indices(polygon.size());
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    indices[i] = static_cast<int>(i);
+  }
+
+  float area = 0.0F;
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    area += cross(polygon[i], polygon[(i + 1) % polygon.size()]);
+  }
+  const float winding = area >= 0.0F ? 1.0F : -1.0F;
+
+  size_t guard = 0;
+  while (indices.size() > 3 && guard++ < polygon.size() * polygon.size()) {
+    bool clipped = false;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      const glm::vec2 &a = polygon[indices[(i + indices.size() - 1) % indices.size()]];
+      const glm::vec2 &b = polygon[indices[i]];
+      const glm::vec2 &c = polygon[indices[(i + 1) % indices.size()]];
+      if (cross(b - a, c - b) * winding <= 0.0F) {
+        continue;
+      }
+
+      bool containsOther = false;
+      for (int k : indices) {
+        const glm::vec2 &p = polygon[k];
+        if (p == a || p == b || p == c) {
+          continue;
+        }
+        if (cross(b - a, p - a) * winding > 0.0F && cross(c - b, p - b) * winding > 0.0F &&
+            cross(a - c, p - c) * winding > 0.0F) {
+          containsOther = true;
+          break;
+        }
+      }
+      if (containsOther) {
+        continue;
+      }
+
+      out.push_back({a, color});
+      out.push_back({b, color});
+      out.push_back({c, color});
+      indices.erase(indices.begin() + static_cast<long>(i));
+      clipped = true;
+      break;
+    }
+    if (!clipped) {
+      break;
+    }
+  }
+
+  if (indices.size() == 3) {
+    out.push_back({polygon[indices[0]], color});
+    out.push_back({polygon[indices[1]], color});
+    out.push_back({polygon[indices[2]], color});
+  }
+}
+
+// Two-pass 3x3 chamfer transform; distances are in cells from the nearest seed node
+void chamferTransform(std::vector<float> &dist, int width, int height) {
+  constexpr float DIAGONAL = 1.41421356F;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      float &d = dist[(y * width) + x];
+      if (x > 0) {
+        d = std::min(d, dist[(y * width) + x - 1] + 1.0F);
+      }
+      if (y > 0) {
+        d = std::min(d, dist[((y - 1) * width) + x] + 1.0F);
+        if (x > 0) {
+          d = std::min(d, dist[((y - 1) * width) + x - 1] + DIAGONAL);
+        }
+        if (x < width - 1) {
+          d = std::min(d, dist[((y - 1) * width) + x + 1] + DIAGONAL);
+        }
+      }
+    }
+  }
+  for (int y = height - 1; y >= 0; --y) {
+    for (int x = width - 1; x >= 0; --x) {
+      float &d = dist[(y * width) + x];
+      if (x < width - 1) {
+        d = std::min(d, dist[(y * width) + x + 1] + 1.0F);
+      }
+      if (y < height - 1) {
+        d = std::min(d, dist[((y + 1) * width) + x] + 1.0F);
+        if (x < width - 1) {
+          d = std::min(d, dist[((y + 1) * width) + x + 1] + DIAGONAL);
+        }
+        if (x > 0) {
+          d = std::min(d, dist[((y + 1) * width) + x - 1] + DIAGONAL);
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+void ObstacleField::clear() {
+  circles.clear();
+  polygons.clear();
+  bitmaps.clear();
+  distance.clear();
+  mesh.clear();
+  meshDirty = true;
+}
+
+void ObstacleField::addCircle(const glm::vec2 &center, float radius) {
+  circles.push_back({center, radius});
+  meshDirty = true;
+}
+
+void ObstacleField::addPolygon(const std::vector<glm::vec2> &vertices) {
+  if (vertices.size() >= 3) {
+    polygons.push_back(vertices);
+    meshDirty = true;
+  }
+}
+
+void ObstacleField::addBitmap(const std::vector<uint8_t> &mask, int maskWidth, int maskHeight,
+                              const glm::vec2 &min, const glm::vec2 &max) {
+  if (maskWidth > 0 && maskHeight > 0 &&
+      mask.size() >= static_cast<size_t>(maskWidth) * maskHeight) {
+    bitmaps.push_back({mask, maskWidth, maskHeight, min, max});
+    meshDirty = true;
+  }
+}
+
+bool ObstacleField::loadBitmap(const std::string &path, const glm::vec2 &min,
+                               const glm::vec2 &max) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  // Header tokens may be separated by whitespace and '#' comments
+  auto readToken = [&file]() {
+    std::string token;
+    while (file && token.empty()) {
+      file >> std::ws;
+      if (file.peek() == '#') {
+        std::string comment;
+        std::getline(file, comment);
+        continue;
+      }
+      file >> token;
+    }
+    return token;
+  };
+
+  if (readToken() != "P5") {
+    return false;
+  }
+  const int maskWidth = std::atoi(readToken().c_str());
+  const int maskHeight = std::atoi(readToken().c_str());
+  const int maxValue = std::atoi(readToken().c_str());
+  if (maskWidth <= 0 || maskHeight <= 0 || maxValue <= 0 || maxValue > 255) {
+    return false;
+  }
+  file.get();
+
+  std::vector<uint8_t> pixels(static_cast<size_t>(maskWidth) * maskHeight);
+  file.read(reinterpret_cast<char *>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+  if (!file) {
+    return false;
+  }
+
+  for (uint8_t &p : pixels) {
+    p = p * 2 < maxValue ? 1 : 0;
+  }
+  addBitmap(pixels, maskWidth, maskHeight, min, max);
+  return true;
+}
+
+void ObstacleField::loadPreset(int preset, const glm::vec2 &extent,
+                               const std::string &bitmapPath) {
+  clear();
+  const glm::vec2 half = extent * 0.5F;
+  const float unit = std::min(extent.x, extent.y);
+
+  switch (preset) {
+  case PRESET_PILLARS: {
+    const int cols = 6;
+    const int rows = 4;
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        const float offset = (y % 2 == 0) ? 0.25F : 0.75F;
+        const glm::vec2 center(-half.x + ((static_cast<float>(x) + offset) * extent.x / cols),
+                               -half.y + ((static_cast<float>(y) + 0.5F) * extent.y / rows));
+        addCircle(center, unit * 0.04F);
+      }
+    }
+    break;
+  }
+  case PRESET_MAZE: {
+    const float t = unit * 0.015F;
+    auto wall = [this](const glm::vec2 &a, const glm::vec2 &b) {
+      addPolygon({{a.x, a.y}, {b.x, a.y}, {b.x, b.y}, {a.x, b.y}});
+    };
+    for (int i = 1; i < 4; ++i) {
+      const float x = -half.x + (extent.x * static_cast<float>(i) / 4.0F);
+      const float gap = (i % 2 == 0) ? half.y * 0.6F : -half.y * 0.6F;
+      if (gap > 0.0F) {
+        wall({x - t, -half.y}, {x + t, gap});
+      } else {
+        wall({x - t, gap}, {x + t, half.y});
+      }
+    }
+    break;
+  }
+  case PRESET_STAR: {
+    std::vector<glm::vec2> star;
+    const int points = 5;
+    for (int i = 0; i < points * 2; ++i) {
+      const float angle =
+          (static_cast<float>(i) * glm::pi<float>() / points) - glm::half_pi<float>();
+      const float r = unit * ((i % 2 == 0) ? 0.25F : 0.1F);
+      star.emplace_back(std::cos(angle) * r, std::sin(angle) * r);
+    }
+    addPolygon(star);
+    break;
+  }
+  case PRESET_BITMAP:
+    loadBitmap(bitmapPath, -half, half);
+    break;
+  default:
+    break;
+  }
+}
+
+float ObstacleField::shapeDistance(const glm::vec2 &p) const {
+  float d = FAR_AWAY;
+  for (const Circle &c : circles) {
+    d = std::min(d, glm::length(p - c.center) - c.radius);
+  }
+
+  for (const auto &polygon : polygons) {
+    float edge = FAR_AWAY;
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+      const glm::vec2 &a = polygon[i];
+      const glm::vec2 &b = polygon[j];
+      edge = std::min(edge, segmentDistance(p, a, b));
+      if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + ((b.x - a.x) * (p.y - a.y) / (b.y - a.y))) {
+        inside = !inside;
+      }
+    }
+    d = std::min(d, inside ? -edge : edge);
+  }
+  return d;
+}
+
+void ObstacleField::rasterizeBitmaps() {
+  const size_t nodes = distance.size();
+  std::vector<float> toSolid(nodes);
+  std::vector<float> toEmpty(nodes);
+
+  for (const Bitmap &bitmap : bitmaps) {
+    const glm::vec2 scale = glm::vec2(bitmap.width, bitmap.height) / (bitmap.max - bitmap.min);
+
+#pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        const glm::vec2 p = origin + (glm::vec2(x, y) * cellSize);
+        const glm::vec2 texel = (p - bitmap.min) * scale;
+        const int mx = static_cast<int>(std::floor(texel.x));
+        const int my = bitmap.maskRow(static_cast<int>(std::floor(texel.y)));
+        const bool solid = mx >= 0 && my >= 0 && mx < bitmap.width && my < bitmap.height &&
+                           bitmap.mask[(static_cast<size_t>(my) * bitmap.width) + mx] != 0;
+        const size_t idx = (static_cast<size_t>(y) * width) + x;
+        toSolid[idx] = solid ? 0.0F : FAR_AWAY;
+        toEmpty[idx] = solid ? FAR_AWAY : 0.0F;
+      }
+    }
+
+    chamferTransform(toSolid, width, height);
+    chamferTransform(toEmpty, width, height);
+
+    // The surface lies half a cell from the last node on either side
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < static_cast<int>(nodes); ++i) {
+      const float d = toSolid[i] > 0.0F ? (toSolid[i] - 0.5F) * cellSize
+                                        : -(toEmpty[i] - 0.5F) * cellSize;
+      distance[i] = std::min(distance[i], d);
+    }
+  }
+}
+
+void ObstacleField::rasterize(float newCellSize, const glm::vec2 &newOrigin,
+                              const glm::vec2 &extent) {
+  if (circles.empty() && polygons.empty() && bitmaps.empty()) {
+    distance.clear();
+    return;
+  }
+
+  cellSize = newCellSize;
+  invCellSize = 1.0F / newCellSize;
+  origin = newOrigin;
+  width = std::max(2, static_cast<int>(std::ceil(extent.x * invCellSize)) + 1);
+  height = std::max(2, static_cast<int>(std::ceil(extent.y * invCellSize)) + 1);
+  distance.assign(static_cast<size_t>(width) * height, FAR_AWAY);
+
+#pragma omp parallel for schedule(dynamic, 4)
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      distance[(static_cast<size_t>(y) * width) + x] =
+          shapeDistance(origin + (glm::vec2(x, y) * cellSize));
+    }
+  }
+
+  if (!bitmaps.empty()) {
+    rasterizeBitmaps();
+  }
+}
+
+float ObstacleField::sample(const glm::vec2 &pos, glm::vec2 &gradient) const {
+  const glm::vec2 g = (pos - origin) * invCellSize;
+  const int x0 = std::clamp(static_cast<int>(std::floor(g.x)), 0, width - 2);
+  const int y0 = std::clamp(static_cast<int>(std::floor(g.y)), 0, height - 2);
+  const float tx = std::clamp(g.x - static_cast<float>(x0), 0.0F, 1.0F);
+  const float ty = std::clamp(g.y - static_cast<float>(y0), 0.0F, 1.0F);
+
+  const float *row0 = distance.data() + (static_cast<size_t>(y0) * width) + x0;
+  const float *row1 = row0 + width;
+  const float d00 = row0[0];
+  const float d10 = row0[1];
+  const float d01 = row1[0];
+  const float d11 = row1[1];
+
+  gradient.x = ((d10 - d00) * (1.0F - ty) + (d11 - d01) * ty) * invCellSize;
+  gradient.y = ((d01 - d00) * (1.0F - tx) + (d11 - d10) * tx) * invCellSize;
+  return glm::mix(glm::mix(d00, d10, tx), glm::mix(d01, d11, tx), ty);
+}
+
+void ObstacleField::collide(Particle &particle, float restitution) const {
+  if (!particle.isActive()) {
+    return;
+  }
+
+  glm::vec2 gradient;
+  const glm::vec2 pos = particle.getPos();
+  const float penetration = sample(pos, gradient) - particle.getCollisionRadius();
+  const float gradientLength = glm::length(gradient);
+  if (penetration >= 0.0F || gradientLength < 1e-6F) {
+    return;
+  }
+
+  // Push out along the distance gradient and reflect the inward velocity component
+  const glm::vec2 normal = gradient / gradientLength;
+  particle.setPos(pos - (normal * penetration));
+  const glm::vec2 vel = particle.getVel();
+  const float normalSpeed = glm::dot(vel, normal);
+  if (normalSpeed < 0.0F) {
+    particle.setVel(vel - (normal * ((1.0F + restitution) * normalSpeed)));
+  }
+}
+
+void ObstacleField::buildMesh(const glm::vec4 &color) {
+  mesh.clear();
+
+  for (const Circle &c : circles) {
+    for (int i = 0; i < CIRCLE_SEGMENTS; ++i) {
+      const float a0 = glm::two_pi<float>() * static_cast<float>(i) / CIRCLE_SEGMENTS;
+      const float a1 = glm::two_pi<float>() * static_cast<float>(i + 1) / CIRCLE_SEGMENTS;
+      mesh.push_back({c.center, color});
+      mesh.push_back({c.center + (glm::vec2(std::cos(a0), std::sin(a0)) * c.radius), color});
+      mesh.push_back({c.center + (glm::vec2(std::cos(a1), std::sin(a1)) * c.radius), color});
+    }
+  }
+
+  for (const auto &polygon : polygons) {
+    triangulate(polygon, color, mesh);
+  }
+
+  // Runs of solid pixels along each row become one quad, with rows placed as the field reads them
+  for (const Bitmap &bitmap : bitmaps) {
+    const glm::vec2 texel = (bitmap.max - bitmap.min) / glm::vec2(bitmap.width, bitmap.height);
+    for (int y = 0; y < bitmap.height; ++y) {
+      const uint8_t *row =
+          bitmap.mask.data() + (static_cast<size_t>(bitmap.maskRow(y)) * bitmap.width);
+      int x = 0;
+      while (x < bitmap.width) {
+        if (row[x] == 0) {
+          ++x;
+          continue;
+        }
+        const int start = x;
+        while (x < bitmap.width && row[x] != 0) {
+          ++x;
+        }
+        const glm::vec2 a = bitmap.min + (glm::vec2(start, y) * texel);
+        const glm::vec2 b = bitmap.min + (glm::vec2(x, y + 1) * texel);
+        mesh.push_back({a, color});
+        mesh.push_back({{b.x, a.y}, color});
+        mesh.push_back({b, color});
+        mesh.push_back({a, color});
+        mesh.push_back({b, color});
+        mesh.push_back({{a.x, b.y}, color});
+      }
+    }
+  }
+
+  meshColor = color;
+  meshDirty = false;
+}
+
+const std::vector<Vertex2D> &ObstacleField::getMesh(const glm::vec4 &color) {
+  if (meshDirty || meshColor != color) {
+    buildMesh(color);
+  }
+  return mesh;
+}
+
+void ObstacleField::render(Renderer &renderer, const glm::vec4 &color) {
+  renderer.drawTriangles(getMesh(color));
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "Graphics/Particle.h"
+#include "Graphics/renderer.h"
+
+// Static obstacles baked into a signed distance field. Circles, polygons and bitmaps are
+// rasterised once into a node grid; afterwards a particle's collision test is one bilinear
+// lookup of distance and gradient, independent of how many shapes make up the map.
+class ObstacleField {
+public:
+  enum Preset {
+    PRESET_NONE = 0,
+    PRESET_PILLARS = 1,
+    PRESET_MAZE = 2,
+    PRESET_STAR = 3,
+    PRESET_BITMAP = 4
+  };
+
+  void clear();
+  void addCircle(const glm::vec2 &center, float radius);
+  void addPolygon(const std::vector<glm::vec2> &vertices);
+  // Non-zero mask pixels are solid; the mask is stretched over [min, max] with row 0, the top
+  // row of an image, at max.y
+  void addBitmap(const std::vector<uint8_t> &mask, int maskWidth, int maskHeight,
+                 const glm::vec2 &min, const glm::vec2 &max);
+  // Binary PGM; dark pixels become solid
+  bool loadBitmap(const std::string &path, const glm::vec2 &min, const glm::vec2 &max);
+  void loadPreset(int preset, const glm::vec2 &extent, const std::string &bitmapPath);
+
+  void rasterize(float cellSize, const glm::vec2 &origin, const glm::vec2 &extent);
+
+  // Distance to the nearest surface, negative inside, with its gradient
+  [[nodiscard]] float sample(const glm::vec2 &pos, glm::vec2 &gradient) const;
+  void collide(Particle &particle, float restitution) const;
+
+  void render(Renderer &renderer, const glm::vec4 &color);
+  // Triangles covering the shapes, rebuilt when they or the colour change
+  [[nodiscard]] const std::vector<Vertex2D> &getMesh(const glm::vec4 &color);
+
+  [[nodiscard]] bool empty() const { return distance.empty(); }
+
+private:
+  struct Circle {
+    glm::vec2 center;
+    float radius;
+  };
+
+  struct Bitmap {
+    std::vector<uint8_t> mask;
+    int width;
+    int height;
+    glm::vec2 min;
+    glm::vec2 max;
+
+    // Mask row of the texel row `row` counted up from min.y; images are stored top row first
+    // while the world is y-up. Its own inverse, so it maps either way.
+    [[nodiscard]] int maskRow(int row) const { return height - 1 - row; }
+  };
+
+  std::vector<Circle> circles;
+  std::vector<std::vector<glm::vec2>> polygons;
+  std::vector<Bitmap> bitmaps;
+
+  int width = 0; // nodes, one more than cells
+  int height = 0;
+  float cellSize = 1.0F;
+  float invCellSize = 1.0F;
+  glm::vec2 origin{0.0F};
+  std::vector<float> distance;
+
+  std::vector<Vertex2D> mesh;
+  glm::vec4 meshColor{0.0F};
+  bool meshDirty = true;
+
+  [[nodiscard]] float shapeDistance(const glm::vec2 &p) const;
+  void rasterizeBitmaps();
+  void buildMesh(const glm::vec4 &color);
+};
@@ -3,36 +3,58 @@
 #ifdef __ARM_NEON
 #include <arm_neon.h>
 #endif
+#include <algorithm>
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 #include <random>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "Graphics/ForceKernel.h"
 #include "Graphics/Simulation.h"
 
 unsigned int Particle::instanceVBO = 0;
 unsigned int Particle::quadVAO = 0;
 unsigned int Particle::quadVBO = 0;
+unsigned int Particle::generatedVAO = 0;
+unsigned int Particle::pointVAO = 0;
 std::unique_ptr<Shader> Particle::particleShader = nullptr;
+std::unique_ptr<Shader> Particle::generatedShader = nullptr;
+std::unique_ptr<Shader> Particle::pointShader = nullptr;
+std::unique_ptr<GpuTimer> Particle::geometryTimers[simulation::GEOMETRY_COUNT];
 std::vector<glm::vec4> Particle::instanceData;
+std::atomic<bool> Particle::instanceDirty{false};
+std::vector<glm::vec4> Particle::visibleData;
+size_t Particle::visibleCount = 0;
+bool Particle::culled = false;
+float Particle::keepRatio = 1.0F;
+uint32_t Particle::keepThreshold = std::numeric_limits<uint32_t>::max();
+float Particle::keepRadiusScale = 1.0F;
+std::unique_ptr<TrailBuffer> Particle::trails = nullptr;
 bool Particle::initialized = false;
 size_t Particle::particleCount = 0;
 const size_t Particle::MAX_PARTICLES = 1000000;
+std::vector<size_t> Particle::freeSlots;
 thread_local std::unordered_map<glm::vec3, int, ColorHash, ColorEqual> colorTypeCache;
 alignas(16) std::vector<std::vector<float>> Particle::interactionMatrix;
+uint32_t Particle::matrixVersion = 1;
+glm::vec2 Particle::halfExtent(std::numeric_limits<float>::max());
+glm::vec2 Particle::speciesBounds[simulation::MAX_SPECIES];
 alignas(4) int Particle::numParticleTypes = 6;                              // Default to 6 types
 alignas(4) float Particle::frictionFactor = std::pow(0.5F, 0.02F / 0.040F); // Friction factor
-alignas(4) const float Particle::BETA = 0.3F;                               // Repulsion parameter
+alignas(4) const float Particle::BETA = DEFAULT_BETA;                       // Repulsion parameter
 
 Particle::Particle()
-    : position(0.0F), velocity(0.0F), acceleration(0.0F), radius(5.0F), color(1.0F), active(true) {
+    : position(0.0F), velocity(0.0F), acceleration(0.0F), radius(5.0F), color(1.0F), type(0),
+      active(true) {
 
   if (!initialized) {
     initializeSharedResources();
   }
 
-  particleIndex = particleCount++;
-  if (particleCount > MAX_PARTICLES) {
-    // Handle error: too many particles
+  particleIndex = acquireSlot();
+  if (particleIndex == NO_SLOT) {
+    // Every slot is taken by a live particle
     active = false;
   }
 
@@ -43,11 +65,11 @@ Particle::Particle()
 
 Particle::Particle(const Particle &other)
     : position(other.position), velocity(other.velocity), acceleration(other.acceleration),
-      radius(other.radius), color(other.color), active(other.active) {
+      radius(other.radius), color(other.color), type(other.type), active(other.active) {
 
-  particleIndex = particleCount++;
-  if (particleCount > MAX_PARTICLES) {
-    // Handle error: too many particles
+  particleIndex = acquireSlot();
+  if (particleIndex == NO_SLOT) {
+    // Every slot is taken by a live particle
     active = false;
   }
 
@@ -56,6 +78,18 @@ Particle::Particle(const Particle &other)
   }
 }
 
+// std::vector only moves elements on growth when the move cannot throw
+static_assert(std::is_nothrow_move_constructible_v<Particle>);
+static_assert(std::is_nothrow_move_assignable_v<Particle>);
+
+// The slot already holds other's instance data, which is now this particle's
+Particle::Particle(Particle &&other) noexcept
+    : position(other.position), velocity(other.velocity), acceleration(other.acceleration),
+      radius(other.radius), color(other.color), type(other.type), active(other.active),
+      particleIndex(other.particleIndex) {
+  other.particleIndex = NO_SLOT;
+}
+
 Particle &Particle::operator=(const Particle &other) {
   if (this != &other) {
     position = other.position;
@@ -63,21 +97,70 @@ Particle &Particle::operator=(const Particle &other) {
     acceleration = other.acceleration;
     radius = other.radius;
     color = other.color;
+    type = other.type;
     active = other.active;
+    updateInstanceData();
+  }
+  return *this;
+}
 
-    if (active) {
+// Slots are swapped rather than released, so the assignment cannot allocate; the moved-from
+// particle gives this one's old slot back when it is destroyed
+Particle &Particle::operator=(Particle &&other) noexcept {
+  if (this != &other) {
+    position = other.position;
+    velocity = other.velocity;
+    acceleration = other.acceleration;
+    radius = other.radius;
+    color = other.color;
+    type = other.type;
+    active = other.active;
+    if (other.particleIndex != NO_SLOT) {
+      std::swap(particleIndex, other.particleIndex);
+    } else {
       updateInstanceData();
     }
   }
   return *this;
 }
 
-Particle::~Particle() { cleanup(); }
+Particle::~Particle() {
+  cleanup();
+  releaseSlot();
+}
+
+size_t Particle::acquireSlot() {
+  if (!freeSlots.empty()) {
+    const size_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    return slot;
+  }
+  if (particleCount < MAX_PARTICLES) {
+    return particleCount++;
+  }
+  return NO_SLOT;
+}
+
+void Particle::releaseSlot() {
+  // Slots handed out before a cleanupSharedResources() belong to the old pool
+  if (particleIndex < particleCount) {
+    freeSlots.push_back(particleIndex);
+  }
+  particleIndex = NO_SLOT;
+}
 
 void Particle::initializeSharedResources() {
   particleShader = std::make_unique<Shader>(
       "../../../../src/Graphics/shaders/particle.vert",
       "../../../../src/Graphics/shaders/particle.frag");
+  generatedShader = std::make_unique<Shader>(
+      "../../../../src/Graphics/shaders/particle_quad.vert",
+      "../../../../src/Graphics/shaders/particle.frag");
+  pointShader = std::make_unique<Shader>("../../../../src/Graphics/shaders/particle_point.vert",
+                                         "../../../../src/Graphics/shaders/particle_point.frag");
+  for (auto &timer : geometryTimers) {
+    timer = std::make_unique<GpuTimer>();
+  }
 
   float quadVertices[] = {-0.5F, 0.5F,  0.0F, 0.0F, 1.0F, 0.5F,  0.5F,  0.0F, 1.0F, 1.0F,
                           0.5F,  -0.5F, 0.0F, 1.0F, 0.0F, -0.5F, -0.5F, 0.0F, 0.0F, 0.0F};
@@ -111,6 +194,21 @@ void Particle::initializeSharedResources() {
                         (void *)(sizeof(glm::vec4)));
   glEnableVertexAttribArray(3);
   glVertexAttribDivisor(3, 1);
+
+  // The other two paths read the same instance buffer, per instance or per point
+  glGenVertexArrays(1, &generatedVAO);
+  glGenVertexArrays(1, &pointVAO);
+  for (const auto &[vao, divisor] : {std::pair{generatedVAO, 1U}, std::pair{pointVAO, 0U}}) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4), (void *)0);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, divisor);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4),
+                          (void *)(sizeof(glm::vec4)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, divisor);
+  }
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
   initInteractionMatrix(numParticleTypes);
@@ -120,13 +218,24 @@ void Particle::initializeSharedResources() {
 void Particle::cleanupSharedResources() {
   if (initialized) {
     glDeleteVertexArrays(1, &quadVAO);
+    glDeleteVertexArrays(1, &generatedVAO);
+    glDeleteVertexArrays(1, &pointVAO);
     glDeleteBuffers(1, &quadVBO);
     glDeleteBuffers(1, &instanceVBO);
     particleShader.reset();
+    generatedShader.reset();
+    pointShader.reset();
+    for (auto &timer : geometryTimers) {
+      timer.reset();
+    }
+    trails.reset();
     instanceData.clear();
     interactionMatrix.clear();
     initialized = false;
     particleCount = 0;
+    freeSlots.clear();
+    culled = false;
+    visibleCount = 0;
   }
 }
 
@@ -136,40 +245,130 @@ void Particle::cleanup() {
 }
 
 void Particle::updateInstanceData() {
-  if (particleIndex < MAX_PARTICLES) {
+  if (particleIndex < particleCount) {
     instanceData[particleIndex * 2] =
         glm::vec4(position.x, position.y, radius, active ? 1.0F : 0.0F);
     instanceData[(particleIndex * 2) + 1] = glm::vec4(color, 0.0F);
+    // Integration calls this from every thread; testing first keeps the line shared once set
+    if (!instanceDirty.load(std::memory_order_relaxed)) {
+      instanceDirty.store(true, std::memory_order_relaxed);
+    }
   }
 }
 
 void Particle::updateAllInstanceData() {
-  if (initialized) {
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-    size_t dataSize = particleCount * 2 * sizeof(glm::vec4);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, instanceData.data());
+  if (!initialized) {
+    return;
+  }
+  if (!simulation::enableTrails) {
+    trails.reset();
+  }
+  // Nothing moved, e.g. while paused: the buffer already holds this frame
+  if (!instanceDirty.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  if (culled) {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, visibleCount * 2 * sizeof(glm::vec4), visibleData.data());
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return;
+  }
+  size_t dataSize = particleCount * 2 * sizeof(glm::vec4);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, instanceData.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Trails take one position slice from the same pack; the history lives only on the GPU
+  if (simulation::enableTrails) {
+    if (!trails) {
+      trails = std::make_unique<TrailBuffer>();
+    }
+    trails->record(instanceData, std::min(particleCount, MAX_PARTICLES), simulation::trailLength);
+  }
+}
+
+void Particle::packVisible(const std::vector<uint32_t> &slots) {
+  visibleData.resize(slots.size() * 2);
+#pragma omp parallel for schedule(static) if (slots.size() > 65536)
+  for (int k = 0; k < static_cast<int>(slots.size()); ++k) {
+    visibleData[static_cast<size_t>(k) * 2] = instanceData[static_cast<size_t>(slots[k]) * 2];
+    visibleData[static_cast<size_t>(k) * 2].z *= keepRadiusScale;
+    visibleData[(static_cast<size_t>(k) * 2) + 1] =
+        instanceData[(static_cast<size_t>(slots[k]) * 2) + 1];
+  }
+  visibleCount = slots.size();
+  culled = true;
+  instanceDirty.store(true, std::memory_order_relaxed);
+}
+
+void Particle::setKeepRatio(float ratio) {
+  keepRatio = std::clamp(ratio, 0.0F, 1.0F);
+  if (keepRatio >= 1.0F) {
+    keepThreshold = std::numeric_limits<uint32_t>::max();
+    keepRadiusScale = 1.0F;
+    return;
+  }
+  // In double: a float rounds the maximum up to 2^32, which does not convert back
+  keepThreshold = static_cast<uint32_t>(static_cast<double>(keepRatio) *
+                                        std::numeric_limits<uint32_t>::max());
+  keepRadiusScale = keepRatio > 0.0F ? 1.0F / std::sqrt(keepRatio) : 1.0F;
+}
+
+void Particle::showAllInstances() {
+  if (culled) {
+    // The buffer holds the packed subset; the next upload restores every slot
+    culled = false;
+    instanceDirty.store(true, std::memory_order_relaxed);
   }
 }
 
 void Particle::renderAll(const glm::mat4 &projection) {
-  if (!initialized || particleCount == 0) {
+  if (!initialized || getDrawnCount() == 0) {
     return;
   }
   updateAllInstanceData();
-  particleShader->use();
-  static GLint projectionLoc = -1;
 
-  if (projectionLoc == -1) {
-    projectionLoc = glGetUniformLocation(particleShader->getProgramID(), "projection");
+  // The frame governor drops trails first when drawing overruns the frame budget
+  if (trails && !simulation::governorStats.reducedRender) {
+    trails->render(projection, instanceVBO);
   }
 
-  if (projectionLoc != -1) {
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, &projection[0][0]);
+  // Timed per path and without the trails, so the paths can be compared with each other
+  const int geometry =
+      std::clamp(simulation::particleGeometry, 0, static_cast<int>(simulation::GEOMETRY_COUNT) - 1);
+  GpuTimer &timer = *geometryTimers[geometry];
+  timer.begin();
+  const auto count = static_cast<GLsizei>(getDrawnCount());
+  switch (geometry) {
+  case simulation::GEOMETRY_GENERATED:
+    generatedShader->use();
+    generatedShader->setMat4("projection", projection);
+    glBindVertexArray(generatedVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    break;
+  case simulation::GEOMETRY_POINTS: {
+    // Vertical pixels per world unit of the viewport the pass draws into
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    pointShader->use();
+    pointShader->setMat4("projection", projection);
+    pointShader->setFloat("pixelsPerUnit", projection[1][1] * 0.5F * viewport[3]);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glBindVertexArray(pointVAO);
+    glDrawArrays(GL_POINTS, 0, count);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    break;
+  }
+  default:
+    particleShader->use();
+    particleShader->setMat4("projection", projection);
+    glBindVertexArray(quadVAO);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count);
+    break;
   }
-  glBindVertexArray(quadVAO);
-  glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, particleCount);
   glBindVertexArray(0);
+  timer.end();
+  simulation::governorStats.geometryGpuMs[geometry] = timer.getMs();
 }
 
 void Particle::initInteractionMatrix(int numTypes) {
@@ -198,67 +397,66 @@ void Particle::randomizeInteractionMatrix() {
       interactionMatrix[i][j] = dist(gen);
     }
   }
+  ++matrixVersion;
 }
 
-float Particle::calculateForce(float r_norm, float a) {
-#ifdef __ARM_NEON
-  float32x2_t beta_vec = vdup_n_f32(BETA);
-  float32x2_t one_vec = vdup_n_f32(1.0F);
-  float32x2_t input_vec = vdup_n_f32(r_norm);
-  float32x2_t a_vec = vdup_n_f32(a);
-  float32x2_t two_vec = vdup_n_f32(2.0F);
-  float32x2_t repulsion = vsub_f32(vdiv_f32(input_vec, beta_vec), one_vec);
-  float32x2_t inner_term = vsub_f32(vsub_f32(vmul_f32(two_vec, input_vec), one_vec), beta_vec);
-  float32x2_t abs_inner = vabs_f32(inner_term);
-  float32x2_t one_minus_beta = vsub_f32(one_vec, beta_vec);
-  float32x2_t attraction = vmul_f32(a_vec, vsub_f32(one_vec, vdiv_f32(abs_inner, one_minus_beta)));
-  uint32x2_t case1 = vclt_f32(input_vec, beta_vec);
-  uint32x2_t case2 = vand_u32(vcgt_f32(input_vec, beta_vec), vclt_f32(input_vec, one_vec));
-  float32x2_t result = vbsl_f32(case1, repulsion, vbsl_f32(case2, attraction, vdup_n_f32(0.0F)));
-  return vget_lane_f32(result, 0);
-#else // Scalar implementation for non-ARM platforms
-  if (r_norm < BETA) {
-    return (r_norm / BETA) - 1.0f;
-  } else if (r_norm < 1.0f) {
-    float inner_term = 2.0f * r_norm - 1.0f - BETA;
-    return a * (1.0f - (std::abs(inner_term) / (1.0f - BETA)));
+float Particle::calculateForce(float r_norm, float a, float beta) {
+  return forceProfile(r_norm, a, beta);
+}
+
+void Particle::prepareIntegration() {
+  if (simulation::enableBounds) {
+    halfExtent = glm::vec2(simulation::boundaryRight - simulation::boundaryLeft,
+                           simulation::boundaryBottom - simulation::boundaryTop) *
+                 0.5F;
   } else {
-    return 0.0f;
+    halfExtent = glm::vec2(std::numeric_limits<float>::max());
+  }
+  for (int t = 0; t < simulation::MAX_SPECIES; ++t) {
+    speciesBounds[t] = halfExtent - simulation::species.collisionRadius[t];
   }
-#endif
 }
 
 void Particle::update(float deltaTime) {
+  if (simulation::useSpeciesPhysics) {
+    const simulation::SpeciesPhysics &table = simulation::species;
+    const int t = std::clamp(type, 0, simulation::MAX_SPECIES - 1);
+    integrate(deltaTime, table.friction[t], table.maxSpeed[t], speciesBounds[t]);
+  } else {
+    integrate(deltaTime, frictionFactor, 0.0F, halfExtent - radius);
+  }
+}
+
+void Particle::integrate(float deltaTime, float friction, float maxSpeed, const glm::vec2 &bound) {
   if (!active) {
     return;
   }
 
+  if (maxSpeed > 0.0F) {
+    const float speedSqr = glm::dot(velocity, velocity);
+    if (speedSqr > maxSpeed * maxSpeed) {
+      velocity *= maxSpeed / std::sqrt(speedSqr);
+    }
+  }
+
 #ifdef __ARM_NEON
   float32x2_t pos = vld1_f32(&position.x);
   float32x2_t vel = vld1_f32(&velocity.x);
 
-  if (__builtin_expect(static_cast<long>(simulation::enableBounds), 1) != 0) {
-    const float32x2_t bounds = {
-        ((simulation::boundaryRight - simulation::boundaryLeft) / 2) - radius,
-        ((simulation::boundaryBottom - simulation::boundaryTop) / 2) - radius};
-
-    uint32x2_t over_bounds = vcgt_f32(pos, bounds);
-    uint32x2_t under_bounds = vclt_f32(pos, vneg_f32(bounds));
+  // Unbounded boxes arrive as FLT_MAX bounds, so the reflection needs no branch
+  const float32x2_t bounds = vld1_f32(&bound.x);
 
-    uint32x2_t out_of_bounds = vorr_u32(over_bounds, under_bounds);
+  uint32x2_t over_bounds = vcgt_f32(pos, bounds);
+  uint32x2_t under_bounds = vclt_f32(pos, vneg_f32(bounds));
 
-    float32x2_t pos_corrected =
-        vbsl_f32(over_bounds, bounds, vbsl_f32(under_bounds, vneg_f32(bounds), pos));
+  uint32x2_t out_of_bounds = vorr_u32(over_bounds, under_bounds);
 
-    const float32x2_t bounce_factor = vdup_n_f32(-0.9F);
-    float32x2_t vel_corrected =
-        vmul_f32(vel, vbsl_f32(out_of_bounds, bounce_factor, vdup_n_f32(1.0F)));
+  pos = vbsl_f32(over_bounds, bounds, vbsl_f32(under_bounds, vneg_f32(bounds), pos));
 
-    pos = pos_corrected;
-    vel = vel_corrected;
-  }
+  const float32x2_t bounce_factor = vdup_n_f32(-0.9F);
+  vel = vmul_f32(vel, vbsl_f32(out_of_bounds, bounce_factor, vdup_n_f32(1.0F)));
 
-  vel = vmul_n_f32(vel, frictionFactor);
+  vel = vmul_n_f32(vel, friction);
 
 #ifdef __ARM_FEATURE_FMA
   pos = vfma_n_f32(pos, vel, deltaTime);
@@ -269,23 +467,13 @@ void Particle::update(float deltaTime) {
   vst1_f32(&position.x, pos);
   vst1_f32(&velocity.x, vel);
 
-#else // Scalar implementation for non-ARM platforms
-  if (simulation::enableBounds) {
-    const float boundX = ((simulation::boundaryRight - simulation::boundaryLeft) / 2) - radius;
-    const float boundY = ((simulation::boundaryBottom - simulation::boundaryTop) / 2) - radius;
-
-    if (position.x > boundX || position.x < -boundX) {
-      position.x = (position.x > boundX) ? boundX : -boundX;
-      velocity.x *= -0.9F;
-    }
-
-    if (position.y > boundY || position.y < -boundY) {
-      position.y = (position.y > boundY) ? boundY : -boundY;
-      velocity.y *= -0.9F;
-    }
-  }
+#else // Scalar implementation for non-ARM platforms; the selects compile to blends
+  const glm::bvec2 outside =
+      glm::greaterThan(position, bound) || glm::lessThan(position, -bound);
+  position = glm::clamp(position, -bound, bound);
+  velocity *= glm::mix(glm::vec2(1.0F), glm::vec2(-0.9F), outside);
 
-  velocity *= frictionFactor;
+  velocity *= friction;
   position += velocity * deltaTime;
 #endif
 
@@ -299,6 +487,7 @@ void Particle::update(float deltaTime) {
 }
 
 void Particle::updateAll(std::vector<Particle> &particles, float deltaTime) {
+  prepareIntegration();
 #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < particles.size(); ++i) {
     particles[i].update(deltaTime);
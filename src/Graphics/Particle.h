@@ -1,19 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <limits>
 #include <memory>
 #include <unordered_map>
 #include <vector>
+#include "Graphics/GpuTimer.h"
 #include "Graphics/Simulation.h"
+#include "Graphics/TrailBuffer.h"
 #include "Graphics/shader.h"
 
+// Per-thread copy of the interaction matrix, refreshed whenever the matrix version moves on
 struct InteractionMatrixCache {
   float values[16][16];
   int size;
+  uint32_t version;
 };
 
-static thread_local InteractionMatrixCache interactionCache = {{0}, 0};
+static thread_local InteractionMatrixCache interactionCache = {{{0}}, 0, 0};
 
 struct ColorHash {
   std::size_t operator()(const glm::vec3 &color) const {
@@ -32,25 +39,50 @@ struct ColorEqual {
   }
 };
 
+// Each live particle owns one slot of the shared instance buffer. A copy is a new particle and
+// takes a new slot; a move hands the slot over, so vector growth and compaction shuffle plain
+// fields without touching the slot pool. Slots come back to a free list when their particle dies.
 class Particle {
 public:
   Particle();
   Particle(const Particle &other);
+  Particle(Particle &&other) noexcept;
   Particle &operator=(const Particle &other);
+  Particle &operator=(Particle &&other) noexcept;
   ~Particle();
 
   void cleanup();
   void update(float deltaTime);
+  // bound is the wall position for this particle's radius, FLT_MAX when unbounded
+  void integrate(float deltaTime, float friction, float maxSpeed, const glm::vec2 &bound);
   static void updateAll(std::vector<Particle> &particles, float deltaTime);
+  // Recomputes the wall bounds of every radius class from the box; call once per step before
+  // update() rather than dividing the box extent in every particle
+  static void prepareIntegration();
 
   static void initializeSharedResources();
   static void cleanupSharedResources();
   static void renderAll(const glm::mat4 &projection);
+  // Uploads the instance buffer if any particle changed since the last upload
   static void updateAllInstanceData();
+  // Whether the next renderAll() would show something the last one did not
+  static bool instancesDirty() { return instanceDirty.load(std::memory_order_relaxed); }
+  // View culling: only the listed instance slots are packed, uploaded and drawn, until
+  // showAllInstances() returns to the full buffer. Trails need the full buffer.
+  static void packVisible(const std::vector<uint32_t> &slots);
+  static void showAllInstances();
+  [[nodiscard]] static size_t getDrawnCount() { return culled ? visibleCount : particleCount; }
+  // Render decimation: a slot is packed when its hash falls under the keep ratio, and packed
+  // radii grow by 1/sqrt(ratio) so the covered area stays put. Slots are stable, so a particle
+  // stays in or out from frame to frame, and a lower ratio keeps a subset of a higher one.
+  static void setKeepRatio(float ratio);
+  [[nodiscard]] static float getKeepRatio() { return keepRatio; }
+  [[nodiscard]] static bool keepsSlot(size_t slot) { return slotHash(slot) <= keepThreshold; }
 
   static void initInteractionMatrix(int numTypes);
   static void randomizeInteractionMatrix();
-  static float calculateForce(float r_norm, float a);
+  static float calculateForce(float r_norm, float a) { return calculateForce(r_norm, a, BETA); }
+  static float calculateForce(float r_norm, float a, float beta);
 
   // setters
   void setPos(const glm::vec2 &pos) {
@@ -64,6 +96,13 @@ public:
   }
 
   void setColor(const glm::vec3 &color) {
+    this->color = color;
+    this->type = typeFromColor(color);
+    updateInstanceData();
+  }
+
+  // Colour for drawing only, e.g. a genome's; the species stays as it is
+  void setDisplayColor(const glm::vec3 &color) {
     this->color = color;
     updateInstanceData();
   }
@@ -83,8 +122,20 @@ public:
   [[nodiscard]] float getSize() const { return this->radius; }
   [[nodiscard]] glm::vec3 getColor() const { return this->color; }
   [[nodiscard]] bool isActive() const { return this->active; }
+  [[nodiscard]] size_t getSlot() const { return this->particleIndex; }
+  [[nodiscard]] bool hasSlot() const { return this->particleIndex != NO_SLOT; }
+
+  [[nodiscard]] int getType() const { return this->type; }
 
-  [[nodiscard]] int getType() const {
+  // Radius used by the wall clamp, contacts and obstacles
+  [[nodiscard]] float getCollisionRadius() const {
+    if (simulation::useSpeciesPhysics) {
+      return simulation::species.collisionRadius[std::clamp(type, 0, simulation::MAX_SPECIES - 1)];
+    }
+    return this->radius;
+  }
+
+  static int typeFromColor(const glm::vec3 &color) {
     static thread_local std::unordered_map<glm::vec3, int, ColorHash> colorTypeCache;
     auto it = colorTypeCache.find(color);
     if (it != colorTypeCache.end()) {
@@ -120,14 +171,16 @@ public:
 
   void setType(int type) {
     if (type >= 0 && type < numParticleTypes && type < simulation::COLORS.size()) {
+      this->type = type;
       this->color = simulation::COLORS[type];
       updateInstanceData();
     }
   }
 
   static float getInteractionStrength(int type1, int type2) {
-    if (interactionCache.size != numParticleTypes) {
+    if (interactionCache.size != numParticleTypes || interactionCache.version != matrixVersion) {
       interactionCache.size = numParticleTypes;
+      interactionCache.version = matrixVersion;
       for (int i = 0; i < numParticleTypes && i < 16; i++) {
         for (int j = 0; j < numParticleTypes && j < 16; j++) {
           interactionCache.values[i][j] = interactionMatrix[i][j];
@@ -145,6 +198,7 @@ public:
   static void setInteractionStrength(int type1, int type2, float strength) {
     if (type1 >= 0 && type1 < numParticleTypes && type2 >= 0 && type2 < numParticleTypes) {
       interactionMatrix[type1][type2] = strength;
+      ++matrixVersion;
     }
   }
 
@@ -156,8 +210,10 @@ public:
   static int getNumParticleTypes() { return numParticleTypes; }
   static float getInteractionRadius() { return interactionRadius; }
   static void setInteractionRadius(float radius) { interactionRadius = radius; }
+  static size_t getTrailMemoryUsage() { return trails ? trails->getMemoryUsage() : 0; }
   static float getFrictionFactor() { return frictionFactor; }
   static void setFrictionFactor(float factor) { frictionFactor = factor; }
+  static float getBeta() { return BETA; }
 
 private:
   glm::vec2 position;
@@ -165,21 +221,52 @@ private:
   glm::vec2 acceleration;
   float radius;
   glm::vec3 color;
+  int type;
   bool active;
-  size_t particleIndex;
+  size_t particleIndex; // instance buffer slot, NO_SLOT once moved from or when the pool is full
 
   void updateInstanceData();
+  static size_t acquireSlot();
+  void releaseSlot();
+  // Integer finalizer hash, spreads consecutive slots uniformly over the 32-bit range
+  static uint32_t slotHash(size_t slot) {
+    auto h = static_cast<uint32_t>(slot);
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    h *= 0x846ca68bU;
+    h ^= h >> 16;
+    return h;
+  }
 
   static GLuint quadVAO;
   static GLuint quadVBO;
   static GLuint instanceVBO;
+  static GLuint generatedVAO; // instance attributes only, corners come from gl_VertexID
+  static GLuint pointVAO;     // instance layout read per vertex, one point per particle
   static std::unique_ptr<Shader> particleShader;
+  static std::unique_ptr<Shader> generatedShader;
+  static std::unique_ptr<Shader> pointShader;
+  static std::unique_ptr<GpuTimer> geometryTimers[simulation::GEOMETRY_COUNT]; // draw call only
   static std::vector<glm::vec4> instanceData;
+  static std::atomic<bool> instanceDirty; // instanceData changed since the last upload
+  static std::vector<glm::vec4> visibleData; // packed slots of the last packVisible()
+  static size_t visibleCount;
+  static bool culled;
+  static float keepRatio;
+  static uint32_t keepThreshold; // largest slot hash kept
+  static float keepRadiusScale;
+  static std::unique_ptr<TrailBuffer> trails;
   static bool initialized;
-  static size_t particleCount;
+  static size_t particleCount; // slots handed out so far, live or free: the drawn range
   static const size_t MAX_PARTICLES;
+  static constexpr size_t NO_SLOT = std::numeric_limits<size_t>::max();
+  static std::vector<size_t> freeSlots;
 
   static std::vector<std::vector<float>> interactionMatrix;
+  static uint32_t matrixVersion; // bumped on every change, only between steps
+  static glm::vec2 halfExtent;    // each particle subtracts its own radius
+  static glm::vec2 speciesBounds[simulation::MAX_SPECIES]; // species collision radii applied
   static int numParticleTypes;
   static float interactionRadius;
   static float frictionFactor;
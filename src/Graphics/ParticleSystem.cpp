@@ -1,14 +1,28 @@
 #include "ParticleSystem.h"
 #include <algorithm>
-#include <arm_neon.h>
+#include <chrono>
 #include <cmath>
-#include <dispatch/dispatch.h>
+#include <glm/gtc/matrix_transform.hpp>
 #include <omp.h>
+#include <random>
 #include "Graphics/Simulation.h"
 
 std::vector<glm::vec2> ParticleSystem::previousForces;
 std::mutex ParticleSystem::previousForcesMutex;
 
+namespace {
+int gridRebuildInterval() {
+  return simulation::neighbourGrid.incremental ? simulation::neighbourGrid.rebuildInterval : 1;
+}
+
+void reportGridStats(const GridStats &stats) {
+  simulation::gridStats.migrationRate =
+      stats.binned > 0 ? static_cast<float>(stats.migrated) / static_cast<float>(stats.binned)
+                       : 0.0F;
+  simulation::gridStats.rebuildSpacing = stats.rebuildSpacing;
+}
+} // namespace
+
 ParticleSystem::ParticleSystem(size_t maxParticles) : maxParticles(maxParticles) {
   particles.reserve(maxParticles);
   Particle::initializeSharedResources();
@@ -19,220 +33,427 @@ ParticleSystem::~ParticleSystem() {
   Particle::cleanupSharedResources();
 }
 
+void ParticleSystem::applyCommands() {
+  dirty |= simulation::commands().drain();
+  if (dirty == simulation::DIRTY_NONE) {
+    return;
+  }
+
+  if ((dirty & simulation::DIRTY_MATRIX) != 0) {
+    for (int a = 0; a < SpeciesInteraction::MAX_TYPES; ++a) {
+      for (int b = 0; b < SpeciesInteraction::MAX_TYPES; ++b) {
+        speciesMatrix[(a * SpeciesInteraction::MAX_TYPES) + b] = getInteractionStrength(a, b);
+      }
+    }
+    world3D.setInteractionMatrix(speciesMatrix.data());
+  }
+
+  // With species physics off every entry is the global constant, so the kernels keep one path
+  if ((dirty & simulation::DIRTY_SPECIES) != 0) {
+    const simulation::SpeciesPhysics &table = simulation::species;
+    for (int t = 0; t < simulation::MAX_SPECIES; ++t) {
+      if (simulation::useSpeciesPhysics) {
+        betaTable[t] = std::clamp(table.beta[t], 0.05F, 0.95F);
+        invMassTable[t] = 1.0F / std::max(table.mass[t], 0.01F);
+      } else {
+        betaTable[t] = Particle::getBeta();
+        invMassTable[t] = 1.0F;
+      }
+    }
+  }
+
+  if ((dirty & (simulation::DIRTY_OBSTACLES | simulation::DIRTY_BOUNDS)) != 0) {
+    simulation::obstacles.rebuild = true;
+  }
+  dirty = simulation::DIRTY_NONE;
+}
+
 void ParticleSystem::update(float deltaTime) {
-  const size_t PARTICLE_THRESHOLD = 100;
+  applyCommands();
+  gridCurrent = false;
+
+  if (simulation::dimensions == 3) {
+    update3D(deltaTime);
+    return;
+  }
+  if (world3DActive) {
+    world3D.clear();
+    world3DActive = false;
+  }
+
+  updateGenomes();
+
+  bool gridPopulated = false;
 
-  if (particles.size() > PARTICLE_THRESHOLD) {
+  // A box only a few interaction ranges across is cheaper to solve by all pairs than by grid
+  const glm::vec2 box(simulation::boundaryRight - simulation::boundaryLeft,
+                      simulation::boundaryBottom - simulation::boundaryTop);
+  const glm::vec2 boxCells = glm::ceil(box / gridCellSize);
+
+  const auto forceStart = std::chrono::high_resolution_clock::now();
+  if (!pairKernelPays<2>(static_cast<int>(boxCells.x * boxCells.y))) {
     calculateInteractionForces(deltaTime);
+    gridPopulated = true;
   } else if (!particles.empty()) {
     simplifiedForceCalculation(deltaTime);
   }
+  simulation::forceStats.stepMs = std::chrono::duration<float, std::milli>(
+                                      std::chrono::high_resolution_clock::now() - forceStart)
+                                      .count();
 
   const size_t BATCH_SIZE = 1024;
 
+  // The obstacle test is one distance field lookup, so it rides along with integration
+  updateObstacles();
+  Particle::prepareIntegration();
+  const bool collideObstacles = simulation::obstacles.enabled && !obstacleField.empty();
+  const float restitution = simulation::obstacles.restitution;
+
   if (particles.size() > BATCH_SIZE) {
 #pragma omp parallel for schedule(static)
     for (int i = 0; i < static_cast<int>(particles.size()); ++i) {
       particles[i].update(deltaTime);
+      if (collideObstacles) {
+        obstacleField.collide(particles[i], restitution);
+      }
     }
   } else {
     for (auto &particle : particles) {
       particle.update(deltaTime);
+      if (collideObstacles) {
+        obstacleField.collide(particle, restitution);
+      }
     }
   }
 
-  if (autoRemoveInactive) {
+  // Contacts are resolved on the integrated positions, before anything samples them
+  if (simulation::contacts.enabled) {
+    contactSolver.solve(particles, deltaTime);
+  }
+
+  if (simulation::resources.enabled) {
+    const glm::vec2 extent(simulation::boundaryRight - simulation::boundaryLeft,
+                           simulation::boundaryBottom - simulation::boundaryTop);
+    resourceField.resize(simulation::resources.cellSize, -extent * 0.5F, extent);
+    resourceField.step(deltaTime);
+    resourceField.couple(particles, deltaTime, resourceIntake);
+  }
+
+  if (!gridPopulated && (simulation::showFieldOverlay || simulation::ecologyMode)) {
+    populateSpatialGrid();
+  }
+
+  // Bin the fields before compaction while grid indices still refer to the right particles
+  if (simulation::showFieldOverlay) {
+    fieldOverlay.compute(grid, particles, Particle::getNumParticleTypes(),
+                         simulation::smoothFieldOverlay);
+  }
+
+  // Ecology recycles dead slots through its free list, so the vector is never compacted while
+  // it runs; leaving the mode drops the free list before compaction invalidates it
+  if (simulation::ecologyMode) {
+    ecology.step(particles, grid, simulation::resources.enabled ? &resourceIntake : nullptr,
+                 genomesActive ? &genomes : nullptr, deltaTime, maxParticles);
+  } else if (ecologyActive) {
+    ecology.reset();
+  }
+  ecologyActive = simulation::ecologyMode;
+
+  if (autoRemoveInactive && !simulation::ecologyMode) {
+    if (genomesActive) {
+      genomes.compact(particles);
+    }
     particles.erase(std::remove_if(particles.begin(), particles.end(),
                                    [](const Particle &p) { return !p.isActive(); }),
                     particles.end());
+    // Compaction shifts the indices the grid holds
+    gridCurrent = gridCurrent && particles.size() == gridBinnedCount;
   }
 }
 
-void ParticleSystem::simplifiedForceCalculation(float deltaTime) {
-  size_t n = particles.size();
+template <typename Fn> void ParticleSystem::withInteraction(Fn &&fn) {
+  switch (simulation::genomeMode) {
+  case simulation::GENOME_DIRECT:
+    fn(genomes.direct());
+    break;
+  case simulation::GENOME_CLUSTERED:
+    fn(genomes.clustered());
+    break;
+  default:
+    fn(SpeciesInteraction{speciesMatrix.data(), types.data()});
+    break;
+  }
+}
 
-  struct ParticleData {
-    glm::vec2 position;
-    int type;
-    bool active;
-  };
+void ParticleSystem::gatherParticleData() {
+  const size_t n = particles.size();
+  positions.resize(n);
+  types.resize(n);
 
-  alignas(16) std::vector<ParticleData> particleData(n);
-  alignas(16) std::vector<glm::vec2> forces(n, glm::vec2(0.0F));
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(n); ++i) {
+    positions[i] = particles[i].getPos();
+    types[i] = std::clamp(particles[i].getType(), 0, SpeciesInteraction::MAX_TYPES - 1);
+  }
 
+  activeParticles.clear();
   for (size_t i = 0; i < n; ++i) {
-    particleData[i].position = particles[i].getPos();
-    particleData[i].type = particles[i].getType();
-    particleData[i].active = particles[i].isActive();
+    if (particles[i].isActive()) {
+      activeParticles.push_back(i);
+    }
   }
+}
 
-#pragma omp parallel for schedule(static)
-  for (int ii = 0; ii < static_cast<int>(n); ++ii) {
-    if (!particleData[ii].active) {
-      continue;
+void ParticleSystem::updateGenomes() {
+  if (simulation::genomeMode == simulation::GENOME_OFF) {
+    if (genomesActive) {
+      // Back to the species palette; genome colours never touched the species
+      genomes.clear();
+      for (auto &particle : particles) {
+        particle.setType(particle.getType());
+      }
+      genomesActive = false;
     }
+    return;
+  }
 
-    glm::vec2 totalForce(0.0F);
-    const glm::vec2 pos_i = particleData[ii].position;
-    const int type_i = particleData[ii].type;
-
-    for (size_t jj = 0; jj < n; ++jj) {
-      if (ii == static_cast<int>(jj) || !particleData[jj].active) {
-        continue;
-      }
+  const size_t previous = genomes.resize(particles.size());
+  for (size_t i = genomesActive ? previous : 0; i < particles.size(); ++i) {
+    particles[i].setDisplayColor(genomes.colorOf(i));
+  }
 
-      const glm::vec2 pos_j = particleData[jj].position;
-      glm::vec2 distVec = pos_j - pos_i;
+  if (simulation::genomeMode == simulation::GENOME_CLUSTERED) {
+    // Offspring inherit their parent's group in between passes, so the matrix stays usable
+    if (!genomesActive || clusteredGroups != simulation::genomeGroups ||
+        ++stepsSinceCluster >= simulation::genomeReclusterInterval) {
+      const int iterations = clusteredGroups != simulation::genomeGroups ? 8 : 2;
+      genomes.cluster(particles, simulation::genomeGroups, iterations);
+      clusteredGroups = simulation::genomeGroups;
+      stepsSinceCluster = 0;
+    }
+  } else {
+    clusteredGroups = 0;
+  }
+  genomesActive = true;
+}
 
-      float distSqr = glm::dot(distVec, distVec);
-      if (distSqr < 2.5F || distSqr >= R_MAX_SQR) {
-        continue;
+void ParticleSystem::update3D(float deltaTime) {
+  const glm::vec3 extent(simulation::boundaryRight - simulation::boundaryLeft,
+                         simulation::boundaryBottom - simulation::boundaryTop,
+                         simulation::view3D.depth);
+  world3D.setExtent(extent);
+
+  if (!world3DActive) {
+    // Lift the current 2D population into the box, spread uniformly in depth
+    std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<float> depth(-0.5F, 0.5F);
+    world3D.clear();
+    world3D.reserve(particles.size());
+    for (const Particle &p : particles) {
+      if (p.isActive()) {
+        world3D.spawn(glm::vec3(p.getPos(), depth(gen) * extent.z), glm::vec3(p.getVel(), 0.0F),
+                      p.getType());
       }
+    }
+    world3DActive = true;
+  }
 
-      float invDist = 1.0F / std::sqrt(distSqr);
-      float distance = distSqr * invDist;
-      float interaction = Particle::getInteractionStrength(type_i, particleData[jj].type);
-      float normDist = distance * invRMax;
-      float forceMag = Particle::calculateForce(normDist, interaction);
+  // The species matrix (set in applyCommands) and physics constants are shared with 2D mode
+  world3D.getParams().rMax = R_MAX;
+  world3D.getParams().friction = Particle::getFrictionFactor();
+  world3D.getParams().bounded = true;
+  world3D.setGridRebuildInterval(gridRebuildInterval());
+  world3D.setTiledTraversal(simulation::neighbourGrid.tiledTraversal);
+
+  world3D.step(deltaTime);
+  reportGridStats(world3D.getGrid().getStats());
+  simulation::view3D.yaw =
+      std::fmod(simulation::view3D.yaw + (simulation::view3D.spinSpeed * deltaTime), 360.0F);
+}
 
-      totalForce += distVec * (forceMag * invDist);
-    }
+void ParticleSystem::render3D(Renderer &renderer) {
+  const simulation::View3D &view = simulation::view3D;
+  const glm::mat4 &ortho = renderer.getProjectionMatrix();
+  const float aspect = ortho[1][1] / ortho[0][0];
+
+  const float yaw = glm::radians(view.yaw);
+  const float pitch = glm::radians(view.pitch);
+  const glm::vec3 eye = view.distance * glm::vec3(std::cos(pitch) * std::sin(yaw), std::sin(pitch),
+                                                  std::cos(pitch) * std::cos(yaw));
+  const glm::mat4 viewMatrix = glm::lookAt(eye, glm::vec3(0.0F), glm::vec3(0.0F, 1.0F, 0.0F));
+  const glm::mat4 projection =
+      glm::perspective(glm::radians(45.0F), aspect, 1.0F, view.distance * 4.0F);
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  pointCloud.render(world3D.getPositions(), world3D.getSpecies(), world3D.size(), viewMatrix,
+                    projection, view.pointSize, static_cast<float>(viewport[3]));
+}
 
-    forces[ii] = totalForce * R_MAX;
+void ParticleSystem::updateObstacles() {
+  simulation::ObstacleSettings &settings = simulation::obstacles;
+  if (!settings.enabled) {
+    return;
   }
 
-#pragma omp parallel for schedule(static)
-  for (int ii = 0; ii < static_cast<int>(n); ++ii) {
-    if (!particleData[ii].active) {
-      continue;
-    }
-    glm::vec2 newVel = particles[ii].getVel() + forces[ii] * deltaTime;
-    particles[ii].setVel(newVel);
+  const glm::vec2 extent(simulation::boundaryRight - simulation::boundaryLeft,
+                         simulation::boundaryBottom - simulation::boundaryTop);
+  if (settings.rebuild || extent != obstacleExtent) {
+    obstacleField.loadPreset(settings.preset, extent, settings.bitmapPath);
+    obstacleField.rasterize(std::max(settings.cellSize, 1.0F), -extent * 0.5F, extent);
+    obstacleExtent = extent;
+    settings.rebuild = false;
   }
 }
 
-void ParticleSystem::calculateInteractionForces(float deltaTime) {
-  const int gridWidth =
-      std::ceil((simulation::boundaryRight - simulation::boundaryLeft) / gridCellSize);
-  const int gridHeight =
-      std::ceil((simulation::boundaryBottom - simulation::boundaryTop) / gridCellSize);
-
-  std::vector<std::vector<size_t>> grid(gridWidth * gridHeight);
-  std::vector<size_t> activeParticles;
-  std::vector<int> cellX(particles.size());
-  std::vector<int> cellY(particles.size());
+void ParticleSystem::simplifiedForceCalculation(float deltaTime) {
+  gatherParticleData();
+  forceBuffer.assign(particles.size(), glm::vec2(0.0F));
+
+  withInteraction([&](const auto &interaction) {
+    accumulatePairForces(pairScratch, activeParticles, positions.data(), types.data(),
+                         betaTable.data(), R_MAX, interaction, forceBuffer.data());
+  });
+  applyForcesOMP(deltaTime);
+}
 
-  populateSpatialGrid(grid, activeParticles, cellX, cellY, gridWidth, gridHeight);
+void ParticleSystem::calculateInteractionForces(float deltaTime) {
+  populateSpatialGrid();
 
-  std::vector<glm::vec2> forceBuffer(particles.size(), glm::vec2(0.0f));
+  forceBuffer.assign(particles.size(), glm::vec2(0.0f));
 
-  computeInteractionForcesOMP(grid, activeParticles, cellX, cellY, forceBuffer, gridWidth,
-                              gridHeight);
-  applyForcesOMP(activeParticles, forceBuffer, deltaTime);
+  computeInteractionForcesOMP();
+  applyForcesOMP(deltaTime);
 }
 
-void ParticleSystem::populateSpatialGrid(std::vector<std::vector<size_t>> &grid,
-                                         std::vector<size_t> &activeParticles,
-                                         std::vector<int> &cellX, std::vector<int> &cellY,
-                                         int gridWidth, int gridHeight) {
-
-  for (size_t i = 0; i < particles.size(); ++i) {
-    if (!particles[i].isActive()) {
-      continue;
-    }
-
-    activeParticles.push_back(i);
+void ParticleSystem::populateSpatialGrid() {
+  gatherParticleData();
 
-    const glm::vec2 &pos = particles[i].getPos();
-    int x = std::clamp(static_cast<int>((pos.x - simulation::boundaryLeft) / gridCellSize), 0,
-                       gridWidth - 1);
-    int y = std::clamp(static_cast<int>((pos.y - simulation::boundaryTop) / gridCellSize), 0,
-                       gridHeight - 1);
+  // The grid spans the same centred box that Particle::update clamps against
+  const glm::vec2 extent(simulation::boundaryRight - simulation::boundaryLeft,
+                         simulation::boundaryBottom - simulation::boundaryTop);
+  grid.resize(gridCellSize, -extent * 0.5F, extent, particles.size());
+  grid.setRebuildInterval(gridRebuildInterval());
 
-    cellX[i] = x;
-    cellY[i] = y;
-    grid[(y * gridWidth) + x].push_back(i);
+  gridCells.resize(particles.size());
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(particles.size()); ++i) {
+    gridCells[i] = particles[i].isActive() ? grid.cellOf(positions[i]) : -1;
   }
+  grid.update(gridCells.data(), gridCells.size());
+  reportGridStats(grid.getStats());
+  gridCurrent = true;
+  gridBinnedCount = particles.size();
 }
 
-void ParticleSystem::computeInteractionForcesOMP(const std::vector<std::vector<size_t>> &grid,
-                                                 const std::vector<size_t> &activeParticles,
-                                                 const std::vector<int> &cellX,
-                                                 const std::vector<int> &cellY,
-                                                 std::vector<glm::vec2> &forceBuffer, int gridWidth,
-                                                 int gridHeight) {
+void ParticleSystem::computeInteractionForcesOMP() {
+  // Every binned particle is active, so the tile order covers the same receivers
+  const bool tiled = simulation::neighbourGrid.tiledTraversal;
+  if (tiled) {
+    grid.tileOrder(tileParticles, particles.size());
+  }
+  const std::vector<size_t> &receivers = tiled ? tileParticles : activeParticles;
+
+  withInteraction([&](const auto &interaction) {
+    accumulateGridForces(grid, receivers, positions.data(), types.data(), betaTable.data(), R_MAX,
+                         interaction, forceBuffer.data());
+  });
+}
 
+void ParticleSystem::applyForcesOMP(float deltaTime) {
 #pragma omp parallel for schedule(static)
   for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
     size_t i = activeParticles[idx];
-    glm::vec2 totalForce(0.0F);
-    const glm::vec2 &pos_i = particles[i].getPos();
-    int type_i = particles[i].getType();
-    int x = cellX[i];
-    int y = cellY[i];
-
-    for (int dy = -1; dy <= 1; ++dy) {
-      for (int dx = -1; dx <= 1; ++dx) {
-        int nx = x + dx;
-        int ny = y + dy;
-        if (nx < 0 || ny < 0 || nx >= gridWidth || ny >= gridHeight) {
-          continue;
-        }
-        const std::vector<unsigned long> &cell = grid[(ny * gridWidth) + nx];
-        for (size_t j : cell) {
-          glm::vec2 dist = particles[j].getPos() - pos_i;
-          float invDist;
-          float normDist;
-          float interaction;
-          float forceMag;
-
-          if (!shouldComputeForce(i, j, particles, dist, invDist, normDist, interaction, forceMag,
-                                  type_i)) {
-            continue;
-          }
-
-          totalForce += dist * (forceMag * invDist);
-        }
-      }
-    }
-    forceBuffer[i] = totalForce * R_MAX;
+    const float scale = invMassTable[types[i]] * deltaTime;
+    particles[i].setVel(particles[i].getVel() + forceBuffer[i] * scale);
   }
 }
 
-bool ParticleSystem::shouldComputeForce(size_t i, size_t j, const std::vector<Particle> &particles,
-                                        const glm::vec2 &dist, float &invDist, float &normDist,
-                                        float &interaction, float &forceMag, int type_i) const {
-  if (i == j || !particles[j].isActive()) {
-    return false;
-  }
+void ParticleSystem::render(const glm::mat4 &projection) { Particle::renderAll(projection); }
 
-  float distSqr = glm::dot(dist, dist);
-  if (distSqr < 2.5F || distSqr >= R_MAX_SQR) {
-    return false;
+void ParticleSystem::cullInstances(const glm::vec2 &viewMin, const glm::vec2 &viewMax) {
+  const glm::vec2 half = glm::vec2(simulation::boundaryRight - simulation::boundaryLeft,
+                                   simulation::boundaryBottom - simulation::boundaryTop) *
+                         0.5F;
+  const bool boxOnScreen =
+      glm::all(glm::lessThanEqual(viewMin, -half)) &&
+      glm::all(glm::greaterThanEqual(viewMax, half));
+  const bool cull = simulation::view2D.cull && !boxOnScreen;
+  const bool decimate = Particle::getKeepRatio() < 1.0F;
+  // Trails keep a per-slot history of every particle, so they need the whole buffer
+  if (simulation::enableTrails || particles.empty() || (!cull && !decimate)) {
+    Particle::showAllInstances();
+    return;
   }
 
-  invDist = 1.0F / std::sqrt(distSqr);
-  float distance = distSqr * invDist;
-  normDist = distance * invRMax;
+  visibleSlots.clear();
+  if (!cull) {
+    for (const Particle &particle : particles) {
+      if (particle.hasSlot() && Particle::keepsSlot(particle.getSlot())) {
+        visibleSlots.push_back(static_cast<uint32_t>(particle.getSlot()));
+      }
+    }
+    Particle::packVisible(visibleSlots);
+    return;
+  }
 
-  interaction = getInteractionStrength(type_i, particles[j].getType());
-  forceMag = Particle::calculateForce(normDist, interaction);
+  // Culls against the grid as the last step binned it, without rebinning here. A cell of margin
+  // covers particle radii and the motion since binning; particles past the walls sit in the edge
+  // cells, which cellOf clamps to.
+  const glm::vec2 margin(gridCellSize);
+  size_t binned = 0;
+  if (gridCurrent && gridBinnedCount <= particles.size()) {
+    const glm::ivec2 lo = grid.cellCoord(grid.cellOf(viewMin - margin));
+    const glm::ivec2 hi = grid.cellCoord(grid.cellOf(viewMax + margin));
+    for (int y = lo.y; y <= hi.y; ++y) {
+      for (int x = lo.x; x <= hi.x; ++x) {
+        for (size_t i : grid.getCell((y * grid.getWidth()) + x)) {
+          if (particles[i].hasSlot() && Particle::keepsSlot(particles[i].getSlot())) {
+            visibleSlots.push_back(static_cast<uint32_t>(particles[i].getSlot()));
+          }
+        }
+      }
+    }
+    binned = gridBinnedCount;
+  }
 
-  return true;
+  // Particles the grid does not hold, appended since binning or all of them after an all-pairs
+  // step, are tested one by one. Births into recycled ecology slots join at the next binning.
+  const glm::vec2 lo = viewMin - margin;
+  const glm::vec2 hi = viewMax + margin;
+  for (size_t i = binned; i < particles.size(); ++i) {
+    const Particle &particle = particles[i];
+    const glm::vec2 pos = particle.getPos();
+    if (particle.hasSlot() && Particle::keepsSlot(particle.getSlot()) &&
+        glm::all(glm::greaterThanEqual(pos, lo)) && glm::all(glm::lessThanEqual(pos, hi))) {
+      visibleSlots.push_back(static_cast<uint32_t>(particle.getSlot()));
+    }
+  }
+  Particle::packVisible(visibleSlots);
 }
 
-void ParticleSystem::applyForcesOMP(const std::vector<size_t> &activeParticles,
-                                    const std::vector<glm::vec2> &forceBuffer, float deltaTime) {
-#pragma omp parallel for schedule(static)
-  for (size_t idx = 0; idx < activeParticles.size(); ++idx) {
-    size_t i = activeParticles[idx];
-    particles[i].setVel(particles[i].getVel() + forceBuffer[i] * deltaTime);
+void ParticleSystem::renderUnderlays(Renderer &renderer) {
+  if (simulation::resources.enabled && simulation::resources.show) {
+    resourceField.render(renderer.getProjectionMatrix());
+  }
+  if (simulation::obstacles.enabled && simulation::obstacles.show) {
+    obstacleField.render(renderer, glm::vec4(0.35F, 0.37F, 0.45F, 1.0F));
   }
 }
 
-void ParticleSystem::render(const glm::mat4 &projection) { Particle::renderAll(projection); }
+void ParticleSystem::renderOverlays(Renderer &renderer) {
+  if (simulation::showFieldOverlay) {
+    fieldOverlay.render(renderer, simulation::fieldOverlaySpecies, simulation::fieldOverlayMode);
+  }
+}
 
 Particle &ParticleSystem::createParticle() {
+  size_t recycled;
+  if (simulation::ecologyMode && ecology.acquireSlot(recycled)) {
+    particles[recycled].setActive(true);
+    return particles[recycled];
+  }
+
   if (particles.size() < maxParticles) {
     if (particles.capacity() == particles.size()) {
       size_t newCapacity = particles.capacity() * 2;
@@ -240,15 +461,16 @@ Particle &ParticleSystem::createParticle() {
       particles.reserve(newCapacity);
     }
     particles.emplace_back();
+    ecology.onParticleCreated(particles.size() - 1);
     return particles.back();
   }
 
   static std::vector<size_t> inactiveIndices;
 
-  static uint64_t lastRebuildTime = 0;
-  uint64_t currentTime = dispatch_time(0, 0);
+  static std::chrono::steady_clock::time_point lastRebuildTime;
+  const auto currentTime = std::chrono::steady_clock::now();
 
-  if (inactiveIndices.empty() || currentTime - lastRebuildTime > 1000000000) { // ~1 second
+  if (inactiveIndices.empty() || currentTime - lastRebuildTime > std::chrono::seconds(1)) {
     inactiveIndices.clear();
     for (size_t i = 0; i < particles.size(); i++) {
       if (!particles[i].isActive()) {
@@ -274,10 +496,15 @@ float ParticleSystem::getInteractionStrength(int type1, int type2) {
   return Particle::getInteractionStrength(type1, type2);
 }
 
-void ParticleSystem::randomizeInteractions() { Particle::randomizeInteractionMatrix(); }
+void ParticleSystem::randomizeInteractions() { simulation::commands().randomizeInteractions(); }
 
 void ParticleSystem::clear() {
   particles.clear();
+  gridCurrent = false;
+  dirty = simulation::DIRTY_ALL;
+  ecology.reset();
+  genomes.clear();
+  genomesActive = false;
   Particle::cleanupSharedResources();
   Particle::initializeSharedResources();
 }
@@ -1,8 +1,20 @@
 #pragma once
 
+#include <array>
 #include <mutex>
 #include <vector>
+#include "CommandQueue.h"
+#include "ContactSolver.h"
+#include "Ecology.h"
+#include "FieldOverlay.h"
+#include "ForceKernel.h"
+#include "GenomePool.h"
+#include "ObstacleField.h"
+#include "PointCloudRenderer.h"
 #include "Particle.h"
+#include "ResourceField.h"
+#include "SpatialGrid.h"
+#include "World.h"
 
 class ParticleSystem {
 public:
@@ -10,7 +22,16 @@ public:
   ~ParticleSystem();
 
   void update(float deltaTime);
+  // Step boundary: applies queued GUI commands and rebuilds whatever they invalidated. update()
+  // calls it first; call it directly while paused so settings still take effect.
+  void applyCommands();
   static void render(const glm::mat4 &projection);
+  void renderUnderlays(Renderer &renderer);
+  void renderOverlays(Renderer &renderer);
+  void render3D(Renderer &renderer);
+  // Restricts the next 2D draw to the particles in grid cells overlapping the world rectangle,
+  // thinned to Particle::getKeepRatio()
+  void cullInstances(const glm::vec2 &viewMin, const glm::vec2 &viewMax);
 
   // Force calculation for particle interactions
   void calculateInteractionForces(float deltaTime);
@@ -36,23 +57,56 @@ private:
   size_t nextParticleIndex = 0;
   bool autoRemoveInactive = true;
   const float R_MAX = 60.0F;
-  const float invRMax = 1.0F / R_MAX;
   const float gridCellSize = R_MAX;
-  const float R_MAX_SQR = R_MAX * R_MAX;
   static std::vector<glm::vec2> previousForces;
   static std::mutex previousForcesMutex;
 
-  void populateSpatialGrid(std::vector<std::vector<size_t>> &grid,
-                           std::vector<size_t> &activeParticles, std::vector<int> &cellX,
-                           std::vector<int> &cellY, int gridWidth, int gridHeight);
-  void computeInteractionForcesOMP(const std::vector<std::vector<size_t>> &grid,
-                                   const std::vector<size_t> &activeParticles,
-                                   const std::vector<int> &cellX, const std::vector<int> &cellY,
-                                   std::vector<glm::vec2> &forceBuffer, int gridWidth,
-                                   int gridHeight);
-  void applyForcesOMP(const std::vector<size_t> &activeParticles,
-                      const std::vector<glm::vec2> &forceBuffer, float deltaTime);
-  bool shouldComputeForce(size_t i, size_t j, const std::vector<Particle> &particles,
-                          const glm::vec2 &dist, float &invDist, float &normDist,
-                          float &interaction, float &forceMag, int type_i) const;
+  SpatialGrid grid;
+  std::vector<int> gridCells;
+  bool gridCurrent = false; // binned during the last step, with indices still valid
+  size_t gridBinnedCount = 0; // particles present at that binning
+  std::vector<uint32_t> visibleSlots;
+  std::vector<size_t> activeParticles;
+  std::vector<size_t> tileParticles; // activeParticles in Hilbert cell order
+  std::vector<glm::vec2> forceBuffer;
+  PairForceScratch<2> pairScratch;
+
+  // Derived data still to rebuild; everything is stale before the first step
+  uint32_t dirty = simulation::DIRTY_ALL;
+
+  // SoA copies gathered once per step for the force kernels
+  std::vector<glm::vec2> positions;
+  std::vector<int> types;
+  std::array<float, SpeciesInteraction::MAX_TYPES * SpeciesInteraction::MAX_TYPES>
+      speciesMatrix{};
+  alignas(64) std::array<float, simulation::MAX_SPECIES> betaTable{};
+  alignas(64) std::array<float, simulation::MAX_SPECIES> invMassTable{};
+
+  GenomePool genomes;
+  bool genomesActive = false;
+  int clusteredGroups = 0;
+  int stepsSinceCluster = 0;
+  FieldOverlay fieldOverlay;
+  Ecology ecology;
+  bool ecologyActive = false;
+  ContactSolver contactSolver;
+
+  // 3D mode runs on a World seeded from the 2D particles when the mode is entered
+  World3D world3D;
+  bool world3DActive = false;
+  PointCloudRenderer pointCloud;
+
+  ObstacleField obstacleField;
+  glm::vec2 obstacleExtent{0.0F};
+  ResourceField resourceField;
+  std::vector<float> resourceIntake;
+
+  void gatherParticleData();
+  void updateGenomes();
+  void updateObstacles();
+  void update3D(float deltaTime);
+  template <typename Fn> void withInteraction(Fn &&fn);
+  void populateSpatialGrid();
+  void computeInteractionForcesOMP();
+  void applyForcesOMP(float deltaTime);
 };
\ No newline at end of file
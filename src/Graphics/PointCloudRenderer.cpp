@@ -0,0 +1,71 @@
+#include "PointCloudRenderer.h"
+#include <algorithm>
+#include <string>
+#include "Graphics/Simulation.h"
+
+PointCloudRenderer::~PointCloudRenderer() {
+  if (pointVAO != 0) {
+    glDeleteVertexArrays(1, &pointVAO);
+    glDeleteBuffers(1, &pointVBO);
+  }
+}
+
+void PointCloudRenderer::initializeResources() {
+  shader = std::make_unique<Shader>("../../../../src/Graphics/shaders/point3D.vert",
+                                    "../../../../src/Graphics/shaders/point3D.frag");
+
+  glGenVertexArrays(1, &pointVAO);
+  glGenBuffers(1, &pointVBO);
+  glBindVertexArray(pointVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, pointVBO);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+void PointCloudRenderer::render(const glm::vec3 *positions, const int *species, size_t count,
+                                const glm::mat4 &view, const glm::mat4 &projection,
+                                float pointSize, float viewportHeight) {
+  if (count == 0) {
+    return;
+  }
+  if (pointVAO == 0) {
+    initializeResources();
+  }
+
+  packed.resize(count);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(count); ++i) {
+    packed[i] = glm::vec4(positions[i], static_cast<float>(species[i]));
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, pointVBO);
+  const size_t bytes = count * sizeof(glm::vec4);
+  if (bytes > capacity) {
+    capacity = std::max(bytes, capacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+  }
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, packed.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  shader->use();
+  shader->setMat4("view", view);
+  shader->setMat4("projection", projection);
+  // World-space diameter to pixels at unit depth
+  shader->setFloat("pointScale", pointSize * viewportHeight * projection[1][1] * 0.5F);
+  const int paletteSize = static_cast<int>(std::min<size_t>(simulation::COLORS.size(), 16));
+  shader->setInt("paletteSize", paletteSize);
+  for (int i = 0; i < paletteSize; ++i) {
+    shader->setVec3("palette[" + std::to_string(i) + "]", simulation::COLORS[i]);
+  }
+
+  glEnable(GL_PROGRAM_POINT_SIZE);
+  glEnable(GL_DEPTH_TEST);
+  glClear(GL_DEPTH_BUFFER_BIT);
+  glBindVertexArray(pointVAO);
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count));
+  glBindVertexArray(0);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_PROGRAM_POINT_SIZE);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Graphics/shader.h"
+
+// Point-sprite path for the 3D mode. Each particle is one GL_POINTS vertex packed as
+// [x, y, z, species]; the vertex shader sizes the sprite by depth and the fragment shader
+// shades it as a sphere, so a frame is one upload and one draw without any quad geometry.
+class PointCloudRenderer {
+public:
+  PointCloudRenderer() = default;
+  ~PointCloudRenderer();
+  PointCloudRenderer(const PointCloudRenderer &) = delete;
+  PointCloudRenderer &operator=(const PointCloudRenderer &) = delete;
+
+  void render(const glm::vec3 *positions, const int *species, size_t count,
+              const glm::mat4 &view, const glm::mat4 &projection, float pointSize,
+              float viewportHeight);
+
+private:
+  std::unique_ptr<Shader> shader;
+  unsigned int pointVAO = 0;
+  unsigned int pointVBO = 0;
+  size_t capacity = 0;
+  std::vector<glm::vec4> packed;
+
+  void initializeResources();
+};
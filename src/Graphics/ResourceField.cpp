@@ -0,0 +1,245 @@
+#include "ResourceField.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include "Graphics/Simulation.h"
+
+namespace {
+// Concentration at which uptake runs at half the consumption rate
+constexpr float HALF_SATURATION = 1.0F;
+} // namespace
+
+ResourceField::~ResourceField() {
+  if (quadVAO != 0) {
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteTextures(1, &texture);
+  }
+}
+
+void ResourceField::resize(float newCellSize, const glm::vec2 &newOrigin,
+                           const glm::vec2 &extent) {
+  const int newWidth = std::max(1, static_cast<int>(std::ceil(extent.x / newCellSize)));
+  const int newHeight = std::max(1, static_cast<int>(std::ceil(extent.y / newCellSize)));
+
+  cellSize = newCellSize;
+  invCellSize = 1.0F / newCellSize;
+  origin = newOrigin;
+
+  if (newWidth == width && newHeight == height) {
+    return;
+  }
+
+  width = newWidth;
+  height = newHeight;
+  // Round rows up to a multiple of 16 floats so every row starts on a 64-byte boundary
+  stride = ((width + 2 + 15) / 16) * 16;
+  current.assign(static_cast<size_t>(stride) * (height + 2), simulation::resources.capacity);
+  next.assign(current.size(), 0.0F);
+}
+
+void ResourceField::fillGhostCells() {
+  // Zero-flux boundary: ghosts mirror the edge cells
+  for (int x = 0; x < width; ++x) {
+    current[x + 1] = current[stride + x + 1];
+    current[((height + 1) * stride) + x + 1] = current[(height * stride) + x + 1];
+  }
+  for (int y = 0; y < height + 2; ++y) {
+    current[y * stride] = current[(y * stride) + 1];
+    current[(y * stride) + width + 1] = current[(y * stride) + width];
+  }
+}
+
+void ResourceField::step(float deltaTime) {
+  if (width == 0) {
+    return;
+  }
+  const auto start = std::chrono::high_resolution_clock::now();
+  const simulation::ResourceSettings &settings = simulation::resources;
+
+  // Explicit diffusion is stable for alpha <= 0.25; split the step when it would not be
+  const float alphaTotal = settings.diffusion * deltaTime * invCellSize * invCellSize;
+  const int substeps = std::max(1, static_cast<int>(std::ceil(alphaTotal / 0.24F)));
+  const float dt = deltaTime / static_cast<float>(substeps);
+  const float alpha = alphaTotal / static_cast<float>(substeps);
+  const float keep = std::max(0.0F, 1.0F - (settings.decay * dt));
+  const float regrowth = settings.regrowth * dt;
+  const float capacity = settings.capacity;
+
+  const int tilesY = (height + TILE_ROWS - 1) / TILE_ROWS;
+  const int tilesX = (width + TILE_COLS - 1) / TILE_COLS;
+
+  for (int s = 0; s < substeps; ++s) {
+    fillGhostCells();
+    const float *src = current.data();
+    float *dst = next.data();
+
+#pragma omp parallel for collapse(2) schedule(static)
+    for (int ty = 0; ty < tilesY; ++ty) {
+      for (int tx = 0; tx < tilesX; ++tx) {
+        const int y0 = (ty * TILE_ROWS) + 1;
+        const int y1 = std::min(y0 + TILE_ROWS, height + 1);
+        const int x0 = (tx * TILE_COLS) + 1;
+        const int x1 = std::min(x0 + TILE_COLS, width + 1);
+
+        for (int y = y0; y < y1; ++y) {
+          const float *row = src + (static_cast<size_t>(y) * stride);
+          const float *up = row - stride;
+          const float *down = row + stride;
+          float *out = dst + (static_cast<size_t>(y) * stride);
+
+#pragma omp simd
+          for (int x = x0; x < x1; ++x) {
+            const float c = row[x];
+            const float laplacian = up[x] + down[x] + row[x - 1] + row[x + 1] - (4.0F * c);
+            const float diffused = (c + (alpha * laplacian)) * keep;
+            out[x] = std::max(0.0F, diffused + (regrowth * (capacity - diffused)));
+          }
+        }
+      }
+    }
+    current.swap(next);
+  }
+
+  simulation::resourceStats.stepMs =
+      std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start)
+          .count();
+}
+
+float ResourceField::sample(const glm::vec2 &pos) const { return sample(current, pos); }
+
+glm::vec2 ResourceField::gradient(const glm::vec2 &pos) const { return gradient(current, pos); }
+
+float ResourceField::sample(const std::vector<float> &values, const glm::vec2 &pos) const {
+  const float fx = std::clamp(((pos.x - origin.x) * invCellSize) - 0.5F, 0.0F,
+                              static_cast<float>(width - 1));
+  const float fy = std::clamp(((pos.y - origin.y) * invCellSize) - 0.5F, 0.0F,
+                              static_cast<float>(height - 1));
+  const int x0 = static_cast<int>(fx);
+  const int y0 = static_cast<int>(fy);
+  const int x1 = std::min(x0 + 1, width - 1);
+  const int y1 = std::min(y0 + 1, height - 1);
+  const float tx = fx - static_cast<float>(x0);
+  const float ty = fy - static_cast<float>(y0);
+
+  const auto value = [&](int x, int y) { return values[((y + 1) * stride) + x + 1]; };
+  const float top = glm::mix(value(x0, y0), value(x1, y0), tx);
+  const float bottom = glm::mix(value(x0, y1), value(x1, y1), tx);
+  return glm::mix(top, bottom, ty);
+}
+
+glm::vec2 ResourceField::gradient(const std::vector<float> &values, const glm::vec2 &pos) const {
+  const float h = cellSize;
+  return glm::vec2(sample(values, pos + glm::vec2(h, 0.0F)) -
+                       sample(values, pos - glm::vec2(h, 0.0F)),
+                   sample(values, pos + glm::vec2(0.0F, h)) -
+                       sample(values, pos - glm::vec2(0.0F, h))) *
+         (0.5F * invCellSize);
+}
+
+void ResourceField::couple(std::vector<Particle> &particles, float deltaTime,
+                           std::vector<float> &intake) {
+  const simulation::ResourceSettings &settings = simulation::resources;
+  const float demand = settings.consumptionRate * deltaTime;
+  const float drift = settings.gradientDrift * deltaTime;
+  intake.assign(particles.size(), 0.0F);
+
+  if (width == 0) {
+    return;
+  }
+  // Drift follows the field as the step left it; next is scratch until the following step, so
+  // it holds the copy while current takes the uptake
+  if (drift != 0.0F) {
+    std::copy(current.begin(), current.end(), next.begin());
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int ii = 0; ii < static_cast<int>(particles.size()); ++ii) {
+    Particle &p = particles[ii];
+    if (!p.isActive()) {
+      continue;
+    }
+
+    const glm::vec2 pos = p.getPos();
+    const int x = std::clamp(static_cast<int>((pos.x - origin.x) * invCellSize), 0, width - 1);
+    const int y = std::clamp(static_cast<int>((pos.y - origin.y) * invCellSize), 0, height - 1);
+    std::atomic_ref<float> cell(current[((y + 1) * stride) + x + 1]);
+
+    // Saturating uptake, computed from and subtracted from the same value: a taker that loses
+    // the exchange to another one on this cell recomputes from what is left, so the cell never
+    // goes below zero
+    float available = cell.load(std::memory_order_relaxed);
+    float taken = 0.0F;
+    do {
+      taken = std::min(available, demand * available / (available + HALF_SATURATION));
+    } while (!cell.compare_exchange_weak(available, available - taken, std::memory_order_relaxed));
+    intake[ii] = taken;
+
+    if (drift != 0.0F) {
+      p.setVel(p.getVel() + (gradient(next, pos) * drift));
+    }
+  }
+}
+
+void ResourceField::initializeResources() {
+  shader = std::make_unique<Shader>("../../../../src/Graphics/shaders/field.vert",
+                                    "../../../../src/Graphics/shaders/field.frag");
+
+  float quadVertices[] = {0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 1.0F, 1.0F, 1.0F};
+
+  glGenVertexArrays(1, &quadVAO);
+  glGenBuffers(1, &quadVBO);
+  glBindVertexArray(quadVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ResourceField::render(const glm::mat4 &projection) {
+  if (width == 0) {
+    return;
+  }
+  if (quadVAO == 0) {
+    initializeResources();
+  }
+
+  // Upload the interior through the padded row length, skipping the ghost ring
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+  const float *interior = current.data() + stride + 1;
+  if (textureWidth != width || textureHeight != height) {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, interior);
+    textureWidth = width;
+    textureHeight = height;
+  } else {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_FLOAT, interior);
+  }
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+  const float capacity = simulation::resources.capacity;
+  shader->use();
+  shader->setMat4("projection", projection);
+  shader->setVec2("gridOrigin", origin);
+  shader->setVec2("gridExtent", glm::vec2(width, height) * cellSize);
+  shader->setFloat("invMaxDensity", capacity > 0.0F ? 1.0F / capacity : 0.0F);
+  shader->setInt("fieldTexture", 0);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(quadVAO);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glBindVertexArray(0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
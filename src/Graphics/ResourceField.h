@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Graphics/Particle.h"
+#include "Graphics/shader.h"
+
+// Scalar nutrient grid, independent of the neighbour grid and of R_MAX. Each step it diffuses
+// through a 5-point stencil, decays and regrows toward capacity. The stencil sweeps cache-sized
+// tiles in parallel over a ghost-padded buffer so the inner loop is branch-free and vectorises.
+class ResourceField {
+public:
+  ResourceField() = default;
+  ~ResourceField();
+  ResourceField(const ResourceField &) = delete;
+  ResourceField &operator=(const ResourceField &) = delete;
+
+  void resize(float cellSize, const glm::vec2 &origin, const glm::vec2 &extent);
+  void step(float deltaTime);
+
+  // Particles take from their cell and, optionally, drift up the gradient. Intake per particle
+  // is written to intake, which the ecology uses as its energy source.
+  void couple(std::vector<Particle> &particles, float deltaTime, std::vector<float> &intake);
+
+  [[nodiscard]] float sample(const glm::vec2 &pos) const;
+  [[nodiscard]] glm::vec2 gradient(const glm::vec2 &pos) const;
+
+  void render(const glm::mat4 &projection);
+
+  [[nodiscard]] int getWidth() const { return width; }
+  [[nodiscard]] int getHeight() const { return height; }
+
+private:
+  static constexpr int TILE_ROWS = 32;
+  static constexpr int TILE_COLS = 256;
+
+  int width = 0;
+  int height = 0;
+  int stride = 0; // padded row length including both ghost columns
+  float cellSize = 0.0F;
+  float invCellSize = 0.0F;
+  glm::vec2 origin{0.0F};
+  std::vector<float> current;
+  std::vector<float> next;
+
+  std::unique_ptr<Shader> shader;
+  unsigned int quadVAO = 0;
+  unsigned int quadVBO = 0;
+  unsigned int texture = 0;
+  int textureWidth = 0;
+  int textureHeight = 0;
+
+  // Bilinear lookups in a padded buffer laid out like current
+  [[nodiscard]] float sample(const std::vector<float> &values, const glm::vec2 &pos) const;
+  [[nodiscard]] glm::vec2 gradient(const std::vector<float> &values, const glm::vec2 &pos) const;
+  void fillGhostCells();
+  void initializeResources();
+};
@@ -0,0 +1,123 @@
+#include "ScaledRenderTarget.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// Frames between scale changes: queries arrive late and the average needs to catch up
+constexpr int SETTLE_FRAMES = 15;
+// The scale grows back once the layer takes less than this share of its budget
+constexpr float GROW_SHARE = 0.6F;
+// Growth per change; cost goes with the square, so this is about 10% more pixels
+constexpr float SCALE_GROWTH = 1.05F;
+// Scales this close to 1 draw straight to the window; the composite would cost more than it saves
+constexpr float FULL_SCALE = 0.95F;
+} // namespace
+
+ScaledRenderTarget::ScaledRenderTarget() {
+  compositeShader = std::make_unique<Shader>("../../../../src/Graphics/shaders/composite.vert",
+                                             "../../../../src/Graphics/shaders/composite.frag");
+  glGenFramebuffers(1, &framebuffer);
+  glGenTextures(1, &colorTexture);
+  // The composite builds its triangle from gl_VertexID, but core profile draws need a VAO bound
+  glGenVertexArrays(1, &compositeVAO);
+}
+
+ScaledRenderTarget::~ScaledRenderTarget() {
+  glDeleteVertexArrays(1, &compositeVAO);
+  glDeleteTextures(1, &colorTexture);
+  glDeleteFramebuffers(1, &framebuffer);
+}
+
+void ScaledRenderTarget::allocate(int width, int height) {
+  textureWidth = width;
+  textureHeight = height;
+
+  glBindTexture(GL_TEXTURE_2D, colorTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+  const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw std::runtime_error("Scaled render target framebuffer is incomplete");
+  }
+}
+
+void ScaledRenderTarget::begin(int pixelWidth, int pixelHeight) {
+  windowWidth = std::max(1, pixelWidth);
+  windowHeight = std::max(1, pixelHeight);
+  timer.begin();
+
+  offscreen = scale < FULL_SCALE;
+  if (!offscreen) {
+    glViewport(0, 0, windowWidth, windowHeight);
+    return;
+  }
+
+  if (windowWidth != textureWidth || windowHeight != textureHeight) {
+    allocate(windowWidth, windowHeight);
+  }
+  layerWidth = std::max(1, static_cast<int>(std::lround(windowWidth * scale)));
+  layerHeight = std::max(1, static_cast<int>(std::lround(windowHeight * scale)));
+
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glViewport(0, 0, layerWidth, layerHeight);
+  glClearColor(0.0F, 0.0F, 0.0F, 0.0F);
+  glClear(GL_COLOR_BUFFER_BIT);
+  // Colour blends as usual, alpha accumulates coverage: the target ends up premultiplied
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ScaledRenderTarget::end() {
+  if (offscreen) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+
+    compositeShader->use();
+    // Sample only the drawn corner, half a texel in so filtering never reads past its edge
+    compositeShader->setVec2("uvScale",
+                             glm::vec2(static_cast<float>(layerWidth) / textureWidth,
+                                       static_cast<float>(layerHeight) / textureHeight));
+    compositeShader->setVec2("uvMax",
+                             glm::vec2((layerWidth - 0.5F) / textureWidth,
+                                       (layerHeight - 0.5F) / textureHeight));
+    compositeShader->setInt("layer", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(compositeVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+
+  timer.end();
+}
+
+void ScaledRenderTarget::adapt(float budgetMs) {
+  const float gpuMs = timer.getMs();
+  if (gpuMs == 0.0F || ++settleFrames < SETTLE_FRAMES) {
+    return;
+  }
+  // Fill cost goes with the pixel count, the square of the scale
+  if (gpuMs > budgetMs) {
+    scale = std::max(MIN_SCALE, scale * std::max(0.7F, std::sqrt(budgetMs / gpuMs)));
+    settleFrames = 0;
+  } else if (gpuMs < GROW_SHARE * budgetMs && scale < 1.0F) {
+    scale = std::min(1.0F, scale * SCALE_GROWTH);
+    settleFrames = 0;
+  }
+}
+
+void ScaledRenderTarget::resetScale() {
+  scale = 1.0F;
+  settleFrames = 0;
+}
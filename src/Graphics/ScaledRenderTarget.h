@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <memory>
+#include "Graphics/GpuTimer.h"
+#include "Graphics/shader.h"
+
+// Offscreen colour target for a layer whose cost is fill rate. The layer is drawn into the
+// lower-left scale x scale share of a window-sized texture and upscaled with bilinear filtering
+// onto the window, so changing the scale never reallocates. The scale follows the layer's GPU
+// time, measured by a GpuTimer around the whole layer.
+class ScaledRenderTarget {
+public:
+  static constexpr float MIN_SCALE = 0.35F;
+
+  ScaledRenderTarget();
+  ~ScaledRenderTarget();
+  ScaledRenderTarget(const ScaledRenderTarget &) = delete;
+  ScaledRenderTarget &operator=(const ScaledRenderTarget &) = delete;
+
+  // Starts the layer for a window of the given pixel size. Below full scale the layer goes to
+  // the offscreen target, cleared to transparent; at full scale straight to the window.
+  void begin(int pixelWidth, int pixelHeight);
+  // Ends the layer and, when it was offscreen, composites it over the window
+  void end();
+
+  // Moves the scale so the layer's GPU time settles under budgetMs
+  void adapt(float budgetMs);
+  void resetScale();
+
+  [[nodiscard]] float getScale() const { return scale; }
+  [[nodiscard]] float getGpuMs() const { return timer.getMs(); }
+
+private:
+  GLuint framebuffer = 0;
+  GLuint colorTexture = 0;
+  GLuint compositeVAO = 0;
+  std::unique_ptr<Shader> compositeShader;
+  GpuTimer timer;
+  bool offscreen = false; // the current layer goes to the target
+
+  int textureWidth = 0;
+  int textureHeight = 0;
+  int windowWidth = 0;
+  int windowHeight = 0;
+  int layerWidth = 0;
+  int layerHeight = 0;
+  float scale = 1.0F;
+  int settleFrames = 0; // frames since the scale last changed
+
+  void allocate(int width, int height);
+};
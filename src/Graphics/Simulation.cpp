@@ -1,4 +1,5 @@
 #include "Simulation.h"
+#include <cmath>
 #include "Common.h"
 
 namespace simulation {
@@ -82,4 +83,126 @@ float boundaryBottom = static_cast<float>(WINDOW_HEIGHT);
 
 // Simulation control
 float simulationSpeed = 1.0F;
+
+// Field overlay
+bool showFieldOverlay = false;
+int fieldOverlayMode = 0;
+int fieldOverlaySpecies = -1;
+bool smoothFieldOverlay = true;
+bool hideParticlesUnderOverlay = false;
+
+// Ecology mode
+bool ecologyMode = false;
+EcologySettings ecology = {
+    1.0F,   // initialEnergy
+    0.35F,  // ambientGain
+    6.0F,   // crowdingCapacity
+    0.08F,  // metabolism
+    0.001F, // movementCost
+    2.0F,   // reproduceThreshold
+    0.5F,   // offspringFraction
+    0.02F,  // mutationRate
+    90.0F,  // maxAge
+    6.0F    // spawnDistance
+};
+EcologyStats ecologyStats = {0, 0, 0, 0};
+
+// Resource field
+ResourceSettings resources = {
+    false,  // enabled
+    true,   // show
+    8.0F,   // cellSize
+    150.0F, // diffusion
+    0.01F,  // decay
+    0.05F,  // regrowth
+    1.0F,   // capacity
+    0.6F,   // consumptionRate
+    0.0F    // gradientDrift
+};
+ResourceStats resourceStats = {0.0F};
+
+// Per-species physical parameters
+namespace {
+SpeciesPhysics defaultSpeciesPhysics() {
+  SpeciesPhysics table{};
+  for (int i = 0; i < MAX_SPECIES; ++i) {
+    table.mass[i] = 1.0F;
+    table.friction[i] = std::pow(0.5F, 0.02F / 0.040F); // matches Particle::frictionFactor
+    table.beta[i] = 0.3F;
+    table.maxSpeed[i] = 0.0F;
+    table.collisionRadius[i] = 5.0F;
+  }
+  return table;
+}
+} // namespace
+
+bool useSpeciesPhysics = false;
+SpeciesPhysics species = defaultSpeciesPhysics();
+
+// Contact solver
+ContactSettings contacts = {
+    false, // enabled
+    4,     // iterations
+    0.5F,  // relaxation
+    0.5F   // velocityFeedback
+};
+ContactStats contactStats = {0.0F, 0};
+ForceStats forceStats = {0.0F};
+
+// Neighbour grid maintenance
+GridSettings neighbourGrid = {
+    true, // incremental
+    100,  // rebuildInterval
+    true  // tiledTraversal
+};
+GridMaintenanceStats gridStats = {0.0F, 0};
+
+// Static obstacles
+ObstacleSettings obstacles = {
+    false, // enabled
+    true,  // show
+    true,  // rebuild
+    1,     // preset
+    4.0F,  // cellSize
+    0.5F,  // restitution
+    "obstacles.pgm"};
+
+// Genome interactions
+int genomeMode = GENOME_OFF;
+int genomeGroups = 64;
+int genomeReclusterInterval = 30;
+float genomeMutation = 0.03F;
+
+// Dimension of the simulation
+int dimensions = 2;
+View3D view3D = {
+    800.0F,  // depth
+    30.0F,   // yaw
+    20.0F,   // pitch
+    1800.0F, // distance
+    6.0F,    // spinSpeed
+    6.0F     // pointSize
+};
+View2D view2D = {
+    0.0F, // centerX
+    0.0F, // centerY
+    1.0F, // zoom
+    true  // cull
+};
+
+// Motion trails
+bool enableTrails = false;
+int trailLength = 16;
+
+int particleGeometry = GEOMETRY_INDEXED;
+
+// Frame-budget governor
+GovernorSettings governor = {
+    true,  // enabled
+    16.7F, // targetMs
+    4,     // maxSubSteps
+    true,  // decimate
+    true   // dynamicResolution
+};
+GovernorStats governorStats = {1, 0.0F, 0.0F, 1.0F, false, 1.0F, 0.0F, 1.0F, {0.0F, 0.0F, 0.0F}};
 } // namespace simulation
@@ -27,4 +27,191 @@ extern bool shouldClearParticles;
 
 // Simulation control
 extern float simulationSpeed;
+
+// Field overlay
+extern bool showFieldOverlay;
+extern int fieldOverlayMode;    // 0 = density heatmap, 1 = flow arrows, 2 = both
+extern int fieldOverlaySpecies; // -1 = all species
+extern bool smoothFieldOverlay;
+extern bool hideParticlesUnderOverlay;
+
+// Ecology mode
+struct EcologySettings {
+  float initialEnergy;
+  float ambientGain;       // energy per second for a particle alone in its cell
+  float crowdingCapacity;  // occupants per cell at which intake halves
+  float metabolism;        // upkeep per second
+  float movementCost;      // per unit speed per second
+  float reproduceThreshold;
+  float offspringFraction; // share of the parent's energy handed to the child
+  float mutationRate;      // probability that a child switches species
+  float maxAge;            // seconds
+  float spawnDistance;
+};
+
+struct EcologyStats {
+  size_t births;
+  size_t deaths;
+  size_t freeSlots;
+  size_t poolSize;
+};
+
+extern bool ecologyMode;
+extern EcologySettings ecology;
+extern EcologyStats ecologyStats;
+
+// Resource field
+struct ResourceSettings {
+  bool enabled;
+  bool show;
+  float cellSize;        // independent of the interaction radius
+  float diffusion;       // px^2 per second
+  float decay;           // fraction per second
+  float regrowth;        // relaxation rate toward capacity per second
+  float capacity;
+  float consumptionRate; // per particle per second at saturation
+  float gradientDrift;   // velocity gain along the resource gradient
+};
+
+struct ResourceStats {
+  float stepMs;
+};
+
+extern ResourceSettings resources;
+extern ResourceStats resourceStats;
+
+// Per-species physical parameters, indexed by species id. Each table is one cache line so a
+// kernel can pull a species' value with a single load.
+constexpr int MAX_SPECIES = 16;
+struct SpeciesPhysics {
+  alignas(64) float mass[MAX_SPECIES];
+  alignas(64) float friction[MAX_SPECIES];        // share of velocity kept per step
+  alignas(64) float beta[MAX_SPECIES];            // repulsion range as a fraction of R_MAX
+  alignas(64) float maxSpeed[MAX_SPECIES];        // px per second, 0 = unlimited
+  alignas(64) float collisionRadius[MAX_SPECIES]; // px, used by the wall clamp
+};
+
+extern bool useSpeciesPhysics;
+extern SpeciesPhysics species;
+
+// Contact solver
+struct ContactSettings {
+  bool enabled;
+  int iterations;         // Jacobi sweeps per step
+  float relaxation;       // share of each sweep's correction that is applied
+  float velocityFeedback; // share of the positional correction turned into velocity
+};
+
+struct ContactStats {
+  float stepMs;
+  size_t contacts;
+};
+
+// Timing of the interaction pass, reported next to the contact solver
+struct ForceStats {
+  float stepMs;
+};
+
+extern ContactSettings contacts;
+extern ContactStats contactStats;
+extern ForceStats forceStats;
+
+// Neighbour grid maintenance
+struct GridSettings {
+  bool incremental;    // move only the particles whose cell changed
+  int rebuildInterval; // steps between full rebuilds
+  bool tiledTraversal; // force threads walk Hilbert-ordered cell blocks, not particle indices
+};
+
+struct GridMaintenanceStats {
+  float migrationRate;   // share of binned particles that changed cell in the last step
+  size_t rebuildSpacing; // steps between the last two full rebuilds
+};
+
+extern GridSettings neighbourGrid;
+extern GridMaintenanceStats gridStats;
+
+// Static obstacles
+struct ObstacleSettings {
+  bool enabled;
+  bool show;
+  bool rebuild;          // set when the map or its resolution changes
+  int preset;            // ObstacleField::Preset
+  float cellSize;        // distance field resolution
+  float restitution;
+  char bitmapPath[256];  // binary PGM for the bitmap preset
+};
+
+extern ObstacleSettings obstacles;
+
+// Genome interactions
+enum GenomeMode { GENOME_OFF = 0, GENOME_DIRECT = 1, GENOME_CLUSTERED = 2 };
+extern int genomeMode;
+extern int genomeGroups;
+extern int genomeReclusterInterval; // steps between k-means passes
+extern float genomeMutation;        // standard deviation of inherited trait noise
+
+// Dimension of the simulation; 3 runs the point-sprite 3D mode
+struct View3D {
+  float depth;     // z extent of the box
+  float yaw;       // degrees
+  float pitch;     // degrees
+  float distance;  // camera distance from the box centre
+  float spinSpeed; // degrees per second of automatic yaw
+  float pointSize; // world-space sprite diameter
+};
+
+extern int dimensions;
+extern View3D view3D;
+
+// 2D camera over the reference frame shown at zoom 1
+struct View2D {
+  float centerX; // world point at the centre of the window
+  float centerY;
+  float zoom;    // screen pixels per world unit relative to the reference frame
+  bool cull;     // pack and draw only the particles in grid cells on screen
+};
+
+extern View2D view2D;
+
+// How 2D particles reach the rasterizer. Indexed quads pull a corner vertex and an index per
+// corner, generated quads build the corners from gl_VertexID, point sprites send one vertex.
+// Indexed quads stay the default until the paths have been compared on real hardware.
+enum ParticleGeometry {
+  GEOMETRY_INDEXED = 0,
+  GEOMETRY_GENERATED = 1,
+  GEOMETRY_POINTS = 2,
+  GEOMETRY_COUNT = 3
+};
+extern int particleGeometry;
+
+// Motion trails
+extern bool enableTrails;
+extern int trailLength;
+
+// Frame-budget governor
+struct GovernorSettings {
+  bool enabled;
+  float targetMs;         // frame time to hold
+  int maxSubSteps;        // simulation steps per displayed frame at most
+  bool decimate;          // draw a stable subset of the particles when drawing overruns
+  bool dynamicResolution; // draw particles at a lower resolution when their GPU time overruns
+};
+
+struct GovernorStats {
+  int subSteps;        // steps run for the last displayed frame
+  float stepMs;        // smoothed cost of one step
+  float renderMs;      // smoothed cost of drawing a frame
+  float simRate;       // simulated seconds per requested second, below 1 when over budget
+  bool reducedRender;  // trails and field overlay suspended to stay in budget
+  float keepRatio;     // share of the visible particles drawn
+  float particleGpuMs; // smoothed GPU time of the particle pass
+  float renderScale;   // particle pass resolution per window axis
+  // Smoothed GPU time of the particle draw call alone, per ParticleGeometry; each entry holds
+  // the last measurement of its path, 0 until that path has been drawn
+  float geometryGpuMs[GEOMETRY_COUNT];
+};
+
+extern GovernorSettings governor;
+extern GovernorStats governorStats;
 } // namespace simulation
\ No newline at end of file
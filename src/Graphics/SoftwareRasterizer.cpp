@@ -0,0 +1,212 @@
+#include "SoftwareRasterizer.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// Smallest disc drawn, in pixels; like the 3D point sprites, far zoomed out particles stay
+// visible instead of missing every pixel centre
+constexpr float MIN_PIXEL_RADIUS = 0.75F;
+constexpr int TILE_PIXELS = SoftwareRasterizer::TILE_SIZE * SoftwareRasterizer::TILE_SIZE;
+
+struct TileRange {
+  int x0, x1, y0, y1;
+};
+
+// Tiles touched by a disc; false when it lies entirely off the image
+bool tilesOf(const glm::vec2 &centre, float radius, int width, int height, TileRange &range) {
+  if (centre.x + radius < 0.0F || centre.y + radius < 0.0F || centre.x - radius >= width ||
+      centre.y - radius >= height) {
+    return false;
+  }
+  // Truncation instead of floor: the two differ only below zero, where the clamp takes over
+  constexpr float INV_TILE = 1.0F / SoftwareRasterizer::TILE_SIZE;
+  const int lastX = (width - 1) / SoftwareRasterizer::TILE_SIZE;
+  const int lastY = (height - 1) / SoftwareRasterizer::TILE_SIZE;
+  range.x0 = std::max(static_cast<int>((centre.x - radius) * INV_TILE), 0);
+  range.x1 = std::min(static_cast<int>((centre.x + radius) * INV_TILE), lastX);
+  range.y0 = std::max(static_cast<int>((centre.y - radius) * INV_TILE), 0);
+  range.y1 = std::min(static_cast<int>((centre.y + radius) * INV_TILE), lastY);
+  return true;
+}
+
+// particle.frag for one pixel: a bright centre fading to a dark rim, alpha falling off over the
+// outer fifth, blended over the tile buffer
+struct DiscShade {
+  float invRadius;
+  glm::vec3 inner;
+  glm::vec3 rim; // outer colour minus inner
+
+  inline void blend(float *__restrict r, float *__restrict g, float *__restrict b, int x,
+                    float dx, float dySqr) const {
+    const float dist = std::sqrt((dx * dx) + dySqr) * invRadius;
+    const float t = std::clamp((dist - 0.8F) * 5.0F, 0.0F, 1.0F);
+    const float alpha = dist <= 1.0F ? 1.0F - (t * t * (3.0F - (2.0F * t))) : 0.0F;
+    // The colour buffer clamps each fragment before blending
+    const float cr = std::min(inner.r + (rim.r * dist), 1.0F);
+    const float cg = std::min(inner.g + (rim.g * dist), 1.0F);
+    const float cb = std::min(inner.b + (rim.b * dist), 1.0F);
+    r[x] += alpha * (cr - r[x]);
+    g[x] += alpha * (cg - g[x]);
+    b[x] += alpha * (cb - b[x]);
+  }
+};
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height)
+    : width(width), height(height), tilesX((width + TILE_SIZE - 1) / TILE_SIZE),
+      tilesY((height + TILE_SIZE - 1) / TILE_SIZE) {
+  if (width <= 0 || height <= 0) {
+    throw std::runtime_error("Software rasterizer needs a positive image size");
+  }
+  pixels.resize(static_cast<size_t>(width) * height * 3);
+  tileStart.resize(static_cast<size_t>(tilesX) * tilesY + 1);
+  setView(glm::vec2(-0.5F * width, -0.5F * height), glm::vec2(0.5F * width, 0.5F * height));
+  setPalette({glm::vec3(1.0F)});
+}
+
+void SoftwareRasterizer::setView(const glm::vec2 &viewMin, const glm::vec2 &viewMax) {
+  topLeft = glm::vec2(viewMin.x, viewMax.y);
+  pixelsPerUnit = glm::vec2(width, height) / (viewMax - viewMin);
+}
+
+void SoftwareRasterizer::setPalette(const std::vector<glm::vec3> &colors) {
+  palette = colors.empty() ? std::vector<glm::vec3>{glm::vec3(1.0F)} : colors;
+}
+
+void SoftwareRasterizer::bin(const glm::vec2 *positions, const int *species, size_t count,
+                             float pixelRadius) {
+  const size_t tiles = static_cast<size_t>(tilesX) * tilesY;
+  const auto paletteSize = static_cast<int>(palette.size());
+  screen.resize(count);
+  tileCounts.assign(tiles * omp_get_max_threads(), 0);
+
+  // Counting sort by tile. Every thread takes a contiguous share of the particles, and a tile's
+  // entries are laid out thread after thread, so the binned order is the index order.
+#pragma omp parallel
+  {
+    const auto threads = static_cast<size_t>(omp_get_num_threads());
+    const auto thread = static_cast<size_t>(omp_get_thread_num());
+    const size_t begin = count * thread / threads;
+    const size_t end = count * (thread + 1) / threads;
+    uint32_t *counts = tileCounts.data() + (thread * tiles);
+
+    for (size_t i = begin; i < end; ++i) {
+      screen[i] = glm::vec2(positions[i].x - topLeft.x, topLeft.y - positions[i].y) *
+                  pixelsPerUnit;
+      TileRange range{};
+      if (!tilesOf(screen[i], pixelRadius, width, height, range)) {
+        continue;
+      }
+      for (int ty = range.y0; ty <= range.y1; ++ty) {
+        for (int tx = range.x0; tx <= range.x1; ++tx) {
+          ++counts[(ty * tilesX) + tx];
+        }
+      }
+    }
+
+#pragma omp barrier
+#pragma omp single
+    {
+      uint32_t total = 0;
+      for (size_t tile = 0; tile < tiles; ++tile) {
+        tileStart[tile] = total;
+        for (size_t t = 0; t < threads; ++t) {
+          const uint32_t n = tileCounts[(t * tiles) + tile];
+          tileCounts[(t * tiles) + tile] = total;
+          total += n;
+        }
+      }
+      tileStart[tiles] = total;
+      binned.resize(total);
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      TileRange range{};
+      if (!tilesOf(screen[i], pixelRadius, width, height, range)) {
+        continue;
+      }
+      // Species past the palette wrap around, as in the field overlay
+      const int colour = species[i] >= 0 && species[i] < paletteSize
+                             ? species[i]
+                             : std::abs(species[i]) % paletteSize;
+      for (int ty = range.y0; ty <= range.y1; ++ty) {
+        for (int tx = range.x0; tx <= range.x1; ++tx) {
+          binned[counts[(ty * tilesX) + tx]++] = Disc{screen[i], colour};
+        }
+      }
+    }
+  }
+}
+
+void SoftwareRasterizer::shadeTile(int tile, float pixelRadius, float *buffer) {
+  const int originX = (tile % tilesX) * TILE_SIZE;
+  const int originY = (tile / tilesX) * TILE_SIZE;
+  const int tileWidth = std::min(TILE_SIZE, width - originX);
+  const int tileHeight = std::min(TILE_SIZE, height - originY);
+  float *red = buffer;
+  float *green = buffer + TILE_PIXELS;
+  float *blue = buffer + (2 * TILE_PIXELS);
+  std::fill(red, red + TILE_PIXELS, background.r);
+  std::fill(green, green + TILE_PIXELS, background.g);
+  std::fill(blue, blue + TILE_PIXELS, background.b);
+
+  for (uint32_t k = tileStart[tile]; k < tileStart[tile + 1]; ++k) {
+    const glm::vec2 centre = binned[k].centre;
+    const glm::vec3 base = palette[binned[k].colour];
+    const DiscShade disc{1.0F / pixelRadius, base * 1.3F, (base * 0.7F) - (base * 1.3F)};
+
+    // Pixels whose centre lies within the disc's bounding square, clipped to the tile
+    const int left = std::max(originX, static_cast<int>(std::ceil(centre.x - pixelRadius - 0.5F)));
+    const int right = std::min(originX + tileWidth - 1,
+                               static_cast<int>(std::floor(centre.x + pixelRadius - 0.5F)));
+    const int top = std::max(originY, static_cast<int>(std::ceil(centre.y - pixelRadius - 0.5F)));
+    const int bottom = std::min(originY + tileHeight - 1,
+                                static_cast<int>(std::floor(centre.y + pixelRadius - 0.5F)));
+
+    // Tile-local columns; dx is measured from the pixel centre
+    const float offsetX = static_cast<float>(originX) + 0.5F - centre.x;
+    for (int y = top; y <= bottom; ++y) {
+      const float dy = static_cast<float>(y) + 0.5F - centre.y;
+      const int row = (y - originY) * TILE_SIZE;
+      float *__restrict r = red + row;
+      float *__restrict g = green + row;
+      float *__restrict b = blue + row;
+#pragma omp simd
+      for (int x = left - originX; x <= right - originX; ++x) {
+        disc.blend(r, g, b, x, static_cast<float>(x) + offsetX, dy * dy);
+      }
+    }
+  }
+
+  const auto toByte = [](float value) {
+    return static_cast<uint8_t>((std::clamp(value, 0.0F, 1.0F) * 255.0F) + 0.5F);
+  };
+  for (int y = 0; y < tileHeight; ++y) {
+    uint8_t *out = pixels.data() + (((static_cast<size_t>(originY + y) * width) + originX) * 3);
+    const int row = y * TILE_SIZE;
+    for (int x = 0; x < tileWidth; ++x) {
+      out[(x * 3) + 0] = toByte(red[row + x]);
+      out[(x * 3) + 1] = toByte(green[row + x]);
+      out[(x * 3) + 2] = toByte(blue[row + x]);
+    }
+  }
+}
+
+void SoftwareRasterizer::render(const glm::vec2 *positions, const int *species, size_t count,
+                                float size) {
+  const float pixelRadius = std::max(0.5F * size * pixelsPerUnit.y, MIN_PIXEL_RADIUS);
+  bin(positions, species, count, pixelRadius);
+
+  const int tiles = tilesX * tilesY;
+#pragma omp parallel
+  {
+    std::vector<float> buffer(static_cast<size_t>(TILE_PIXELS) * 3);
+    // Crowded tiles cost far more than empty ones
+#pragma omp for schedule(dynamic)
+    for (int tile = 0; tile < tiles; ++tile) {
+      shadeTile(tile, pixelRadius, buffer.data());
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+// CPU renderer for the 2D particle field, for machines without any GL stack. Particles are
+// binned into screen tiles in parallel, then every tile is shaded by a single thread with the
+// particle.frag disc, so no two threads write the same pixel and no locks are taken. Within a
+// tile particles blend in index order, the order the instanced draw uses.
+class SoftwareRasterizer {
+public:
+  static constexpr int TILE_SIZE = 32;
+
+  SoftwareRasterizer(int width, int height);
+
+  // World rectangle mapped onto the image; y grows upward as in the GL projection
+  void setView(const glm::vec2 &viewMin, const glm::vec2 &viewMax);
+  // Base colour per species, shaded as particle.frag does
+  void setPalette(const std::vector<glm::vec3> &colors);
+  void setBackground(const glm::vec3 &color) { background = color; }
+
+  // size is the particle radius of the GL path: the side of the quad, so the disc's diameter
+  void render(const glm::vec2 *positions, const int *species, size_t count, float size);
+
+  // 8-bit RGB, top row first
+  [[nodiscard]] const std::vector<uint8_t> &getPixels() const { return pixels; }
+  [[nodiscard]] int getWidth() const { return width; }
+  [[nodiscard]] int getHeight() const { return height; }
+
+private:
+  // Binned copies rather than indices: shading then streams through its tile's discs instead of
+  // gathering positions and species from all over the particle arrays
+  struct Disc {
+    glm::vec2 centre; // pixels
+    int colour;       // palette entry
+  };
+
+  int width;
+  int height;
+  int tilesX;
+  int tilesY;
+  glm::vec2 topLeft{0.0F}; // world position of the image's top-left corner
+  glm::vec2 pixelsPerUnit{1.0F};
+  glm::vec3 background{0.0F};
+  std::vector<glm::vec3> palette;
+
+  std::vector<glm::vec2> screen;    // pixel-space centres of the last render
+  std::vector<uint32_t> tileCounts; // per thread and tile, then the thread's write offsets
+  std::vector<uint32_t> tileStart;  // first binned entry of every tile, plus the total
+  std::vector<Disc> binned;         // discs grouped by tile, in index order within a tile
+  std::vector<uint8_t> pixels;
+
+  void bin(const glm::vec2 *positions, const int *species, size_t count, float pixelRadius);
+  // buffer holds TILE_SIZE^2 floats per channel, planar so pixel runs are contiguous
+  void shadeTile(int tile, float pixelRadius, float *buffer);
+};
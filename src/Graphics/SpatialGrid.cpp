@@ -0,0 +1,247 @@
+#include "SpatialGrid.h"
+#include <cmath>
+#include <numeric>
+#include <omp.h>
+
+namespace {
+// Free slots a cell gets past its occupancy at a rebuild
+uint32_t slackFor(uint32_t occupancy) { return (occupancy / 4) + 4; }
+
+// Past this share of moved particles a rebuild is cheaper than moving them one by one
+constexpr size_t MAX_MIGRATION_DIVISOR = 4;
+
+// Distance along a D-dimensional Hilbert curve of side 2^bits (Skilling's transform of the
+// axes into the transposed index, whose bits are then interleaved)
+template <int D> uint64_t hilbertKey(glm::vec<D, int> coord, int bits) {
+  uint32_t x[D];
+  for (int d = 0; d < D; ++d) {
+    x[d] = static_cast<uint32_t>(coord[d]);
+  }
+
+  for (uint32_t q = 1U << (bits - 1); q > 1; q >>= 1) {
+    const uint32_t p = q - 1;
+    for (int d = 0; d < D; ++d) {
+      if ((x[d] & q) != 0) {
+        x[0] ^= p;
+      } else {
+        const uint32_t t = (x[0] ^ x[d]) & p;
+        x[0] ^= t;
+        x[d] ^= t;
+      }
+    }
+  }
+  for (int d = 1; d < D; ++d) {
+    x[d] ^= x[d - 1];
+  }
+  uint32_t t = 0;
+  for (uint32_t q = 1U << (bits - 1); q > 1; q >>= 1) {
+    if ((x[D - 1] & q) != 0) {
+      t ^= q - 1;
+    }
+  }
+
+  uint64_t key = 0;
+  for (int b = bits - 1; b >= 0; --b) {
+    for (int d = 0; d < D; ++d) {
+      key = (key << 1) | (((x[d] ^ t) >> b) & 1U);
+    }
+  }
+  return key;
+}
+} // namespace
+
+template <int D>
+void SpatialGridND<D>::resize(float newCellSize, const Vec &newOrigin, const Vec &extent,
+                              size_t particleCapacity) {
+  IVec newDims;
+  size_t cellTotal = 1;
+  for (int d = 0; d < D; ++d) {
+    newDims[d] = std::max(1, static_cast<int>(std::ceil(extent[d] / newCellSize)));
+    cellTotal *= static_cast<size_t>(newDims[d]);
+  }
+
+  // Binned cell indices only stay meaningful on unchanged geometry
+  if (newCellSize != cellSize || newOrigin != origin || newDims != dims) {
+    valid = false;
+  }
+  cellSize = newCellSize;
+  invCellSize = 1.0F / newCellSize;
+  origin = newOrigin;
+  if (cellCount.size() != cellTotal) {
+    cellCount.assign(cellTotal, 0);
+    cellStart.assign(cellTotal + 1, 0);
+  }
+
+  if (newDims != dims) {
+    dims = newDims;
+    int side = 1;
+    for (int d = 0; d < D; ++d) {
+      side = std::max(side, dims[d]);
+    }
+    int bits = 1;
+    while ((1 << bits) < side) {
+      ++bits;
+    }
+    std::vector<uint64_t> keys(cellTotal);
+    for (size_t c = 0; c < cellTotal; ++c) {
+      keys[c] = hilbertKey<D>(cellCoord(static_cast<int>(c)), bits);
+    }
+    hilbertCells.resize(cellTotal);
+    std::iota(hilbertCells.begin(), hilbertCells.end(), 0);
+    std::sort(hilbertCells.begin(), hilbertCells.end(),
+              [&](int a, int b) { return keys[a] < keys[b]; });
+  }
+
+  particleCells.reserve(particleCapacity);
+  particleSlots.reserve(particleCapacity);
+}
+
+template <int D> void SpatialGridND<D>::rebuild(const int *cells, size_t count) {
+  const size_t cellTotal = cellCount.size();
+  std::fill(cellCount.begin(), cellCount.end(), 0);
+  for (size_t i = 0; i < count; ++i) {
+    if (cells[i] >= 0) {
+      ++cellCount[cells[i]];
+    }
+  }
+
+  cellStart[0] = 0;
+  for (size_t c = 0; c < cellTotal; ++c) {
+    cellStart[c + 1] = cellStart[c] + cellCount[c] + slackFor(cellCount[c]);
+  }
+  slots.resize(cellStart[cellTotal]);
+
+  std::fill(cellCount.begin(), cellCount.end(), 0);
+  particleCells.assign(cells, cells + count);
+  particleSlots.resize(count);
+  size_t binned = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const int cell = cells[i];
+    if (cell < 0) {
+      continue;
+    }
+    const uint32_t slot = cellStart[cell] + cellCount[cell]++;
+    slots[slot] = i;
+    particleSlots[i] = slot;
+    ++binned;
+  }
+
+  valid = true;
+  stats.binned = binned;
+  stats.migrated = binned;
+  stats.rebuilt = true;
+  stats.rebuildSpacing = stats.updatesSinceRebuild;
+  stats.updatesSinceRebuild = 0;
+  ++stats.rebuilds;
+}
+
+template <int D> bool SpatialGridND<D>::moveParticle(size_t particle, int cell) {
+  const int from = particleCells[particle];
+  if (from >= 0) {
+    // Swap the cell's last particle into the vacated slot
+    const uint32_t slot = particleSlots[particle];
+    const uint32_t last = cellStart[from] + --cellCount[from];
+    slots[slot] = slots[last];
+    particleSlots[slots[slot]] = slot;
+    --stats.binned;
+  }
+  particleCells[particle] = cell;
+  if (cell < 0) {
+    return true;
+  }
+
+  if (cellStart[cell] + cellCount[cell] == cellStart[cell + 1]) {
+    return false;
+  }
+  const uint32_t slot = cellStart[cell] + cellCount[cell]++;
+  slots[slot] = particle;
+  particleSlots[particle] = slot;
+  ++stats.binned;
+  return true;
+}
+
+template <int D> void SpatialGridND<D>::update(const int *cells, size_t count) {
+  ++stats.updatesSinceRebuild;
+  if (!valid || stats.updatesSinceRebuild >= static_cast<size_t>(rebuildInterval)) {
+    rebuild(cells, count);
+    return;
+  }
+
+  // Particles past the new count leave the grid, new ones enter it from nowhere
+  const size_t previous = particleCells.size();
+  size_t migrated = 0;
+  for (size_t i = count; i < previous; ++i) {
+    if (particleCells[i] >= 0) {
+      moveParticle(i, -1);
+      ++migrated;
+    }
+  }
+  particleCells.resize(count, -1);
+  particleSlots.resize(count);
+
+  // Find movers in parallel; apply them serially in thread order so the cell order, and with it
+  // the force summation order, does not depend on scheduling
+  threadMoves.resize(static_cast<size_t>(omp_get_max_threads()));
+#pragma omp parallel
+  {
+    std::vector<Move> &moves = threadMoves[omp_get_thread_num()];
+    moves.clear();
+#pragma omp for schedule(static)
+    for (int i = 0; i < static_cast<int>(count); ++i) {
+      if (cells[i] != particleCells[i]) {
+        moves.push_back({static_cast<size_t>(i), cells[i]});
+      }
+    }
+  }
+
+  for (const std::vector<Move> &moves : threadMoves) {
+    migrated += moves.size();
+  }
+  if (migrated > count / MAX_MIGRATION_DIVISOR) {
+    rebuild(cells, count);
+    stats.migrated = migrated;
+    return;
+  }
+
+  for (const std::vector<Move> &moves : threadMoves) {
+    for (const Move &move : moves) {
+      if (!moveParticle(move.particle, move.cell)) {
+        // Out of slack: the partial update is discarded along with the old layout
+        rebuild(cells, count);
+        stats.migrated = migrated;
+        return;
+      }
+    }
+  }
+
+  stats.migrated = migrated;
+  stats.rebuilt = false;
+}
+
+template <int D> void SpatialGridND<D>::tileOrder(std::vector<size_t> &order, size_t receivers) {
+  const int cellTotal = static_cast<int>(hilbertCells.size());
+  tileOffsets.resize(cellTotal + 1);
+  tileOffsets[0] = 0;
+
+#pragma omp parallel for schedule(static)
+  for (int k = 0; k < cellTotal; ++k) {
+    const std::span<const size_t> cell = getCell(hilbertCells[k]);
+    tileOffsets[k + 1] = static_cast<uint32_t>(
+        std::count_if(cell.begin(), cell.end(), [&](size_t i) { return i < receivers; }));
+  }
+  std::inclusive_scan(tileOffsets.begin() + 1, tileOffsets.end(), tileOffsets.begin() + 1);
+  order.resize(tileOffsets[cellTotal]);
+
+#pragma omp parallel for schedule(static)
+  for (int k = 0; k < cellTotal; ++k) {
+    size_t out = tileOffsets[k];
+    for (size_t i : getCell(hilbertCells[k])) {
+      if (i < receivers) {
+        order[out++] = i;
+      }
+    }
+  }
+}
+
+template class SpatialGridND<2>;
+template class SpatialGridND<3>;
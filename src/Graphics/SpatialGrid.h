@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+// Counters of the incremental grid maintenance
+struct GridStats {
+  size_t binned = 0;          // particles in the grid after the last update
+  size_t migrated = 0;        // particles that changed cell in the last update
+  bool rebuilt = false;       // whether the last update rebuilt the grid from scratch
+  size_t updatesSinceRebuild = 0;
+  size_t rebuildSpacing = 0;  // updates between the last two rebuilds
+  size_t rebuilds = 0;
+};
+
+// Uniform bucket grid over the simulation box. The dimension is a template parameter; the 2D
+// instantiation compiles to the same code the grid had before 3D existed.
+//
+// Cells live in one flat slot array, each with slack past its occupancy. Particles rarely leave
+// their cell in a step, so update() only moves the few whose cell changed, in O(1) each, and
+// rebuilds from scratch when a cell runs out of slack, the geometry changes, too many particles
+// moved, or every rebuildInterval updates to restore the slack.
+template <int D> class SpatialGridND {
+public:
+  static_assert(D == 2 || D == 3, "SpatialGridND supports 2D and 3D");
+  using Vec = glm::vec<D, float>;
+  using IVec = glm::vec<D, int>;
+
+  void resize(float cellSize, const Vec &origin, const Vec &extent, size_t particleCapacity);
+
+  // cells[i] is the cell of particle i, or -1 to leave it out of the grid
+  void rebuild(const int *cells, size_t count);
+  void update(const int *cells, size_t count);
+  // Updates between forced rebuilds; 1 rebuilds on every update
+  void setRebuildInterval(int updates) { rebuildInterval = std::max(updates, 1); }
+  [[nodiscard]] const GridStats &getStats() const { return stats; }
+
+  // Binned particles below receivers, cell by cell with the cells in Hilbert curve order. Cut
+  // into static chunks, the list gives each thread a compact block of neighbouring cells, so
+  // its working set stays in its own cache instead of spanning the whole box.
+  void tileOrder(std::vector<size_t> &order, size_t receivers);
+
+  [[nodiscard]] int cellOf(const Vec &pos) const {
+    int index = 0;
+    for (int d = D - 1; d >= 0; --d) {
+      const int c = std::clamp(static_cast<int>((pos[d] - origin[d]) * invCellSize), 0,
+                               dims[d] - 1);
+      index = (index * dims[d]) + c;
+    }
+    return index;
+  }
+
+  [[nodiscard]] IVec cellCoord(int index) const {
+    IVec coord;
+    for (int d = 0; d < D; ++d) {
+      coord[d] = index % dims[d];
+      index /= dims[d];
+    }
+    return coord;
+  }
+
+  // Visits the 3^D block of cells around a cell, clipped to the grid
+  template <typename Fn> void forEachNeighbourCell(int cell, Fn &&fn) const {
+    const IVec c = cellCoord(cell);
+    if constexpr (D == 2) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        const int ny = c.y + dy;
+        if (ny < 0 || ny >= dims.y) {
+          continue;
+        }
+        for (int dx = -1; dx <= 1; ++dx) {
+          const int nx = c.x + dx;
+          if (nx < 0 || nx >= dims.x) {
+            continue;
+          }
+          fn((ny * dims.x) + nx);
+        }
+      }
+    } else {
+      for (int dz = -1; dz <= 1; ++dz) {
+        const int nz = c.z + dz;
+        if (nz < 0 || nz >= dims.z) {
+          continue;
+        }
+        for (int dy = -1; dy <= 1; ++dy) {
+          const int ny = c.y + dy;
+          if (ny < 0 || ny >= dims.y) {
+            continue;
+          }
+          for (int dx = -1; dx <= 1; ++dx) {
+            const int nx = c.x + dx;
+            if (nx < 0 || nx >= dims.x) {
+              continue;
+            }
+            fn((((nz * dims.y) + ny) * dims.x) + nx);
+          }
+        }
+      }
+    }
+  }
+
+  [[nodiscard]] std::span<const size_t> getCell(int index) const {
+    return {slots.data() + cellStart[index], cellCount[index]};
+  }
+  [[nodiscard]] int getParticleCell(size_t particle) const { return particleCells[particle]; }
+  [[nodiscard]] Vec getCellCenter(int index) const {
+    return origin + (Vec(cellCoord(index)) + 0.5F) * cellSize;
+  }
+
+  [[nodiscard]] int getWidth() const { return dims.x; }
+  [[nodiscard]] int getHeight() const { return dims.y; }
+  [[nodiscard]] IVec getDims() const { return dims; }
+  [[nodiscard]] int getCellCount() const { return static_cast<int>(cellCount.size()); }
+  [[nodiscard]] float getCellSize() const { return cellSize; }
+  [[nodiscard]] Vec getOrigin() const { return origin; }
+  [[nodiscard]] Vec getExtent() const { return Vec(dims) * cellSize; }
+
+private:
+  struct Move {
+    size_t particle;
+    int cell;
+  };
+
+  bool moveParticle(size_t particle, int cell);
+
+  float cellSize = 1.0F;
+  float invCellSize = 1.0F;
+  Vec origin{0.0F};
+  IVec dims{0};
+  bool valid = false; // false until binned on the current geometry
+  int rebuildInterval = 100;
+  std::vector<uint32_t> cellStart; // slots of cell c begin at cellStart[c]
+  std::vector<uint32_t> cellCount; // occupied slots of cell c
+  std::vector<size_t> slots;       // particle indices; capacity of cell c ends at cellStart[c+1]
+  std::vector<int> particleCells;
+  std::vector<uint32_t> particleSlots;
+  std::vector<std::vector<Move>> threadMoves; // per-thread migration buffers
+  std::vector<int> hilbertCells;              // cell indices along the curve
+  std::vector<uint32_t> tileOffsets;
+  GridStats stats;
+};
+
+using SpatialGrid = SpatialGridND<2>;
+using SpatialGrid3D = SpatialGridND<3>;
@@ -0,0 +1,103 @@
+#include "TrailBuffer.h"
+#include <algorithm>
+
+namespace {
+// Slot capacity grows in fixed chunks so a slowly rising particle count does not reset the
+// history every frame
+constexpr size_t CAPACITY_CHUNK = 65536;
+// Segments longer than this are a reused slot or a compaction, not motion
+constexpr float TRAIL_BREAK_DISTANCE = 64.0F;
+} // namespace
+
+TrailBuffer::TrailBuffer() {
+  trailShader = std::make_unique<Shader>("../../../../src/Graphics/shaders/trail.vert",
+                                         "../../../../src/Graphics/shaders/trail.frag");
+  glGenBuffers(1, &historyBuffer);
+  glGenTextures(1, &historyTexture);
+  glGenVertexArrays(1, &trailVAO);
+}
+
+TrailBuffer::~TrailBuffer() {
+  glDeleteVertexArrays(1, &trailVAO);
+  glDeleteTextures(1, &historyTexture);
+  glDeleteBuffers(1, &historyBuffer);
+}
+
+void TrailBuffer::allocate(size_t newCapacity, int newLength) {
+  capacity = newCapacity;
+  length = newLength;
+  head = 0;
+  recordedFrames = 0;
+
+  glBindBuffer(GL_TEXTURE_BUFFER, historyBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, capacity * length * sizeof(glm::vec2), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindTexture(GL_TEXTURE_BUFFER, historyTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, historyBuffer);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void TrailBuffer::reset() {
+  head = 0;
+  recordedFrames = 0;
+}
+
+void TrailBuffer::record(const std::vector<glm::vec4> &instanceData, size_t slotCount,
+                         int newLength) {
+  newLength = std::clamp(newLength, 2, MAX_LENGTH);
+  slotCount = std::min(slotCount, instanceData.size() / 2);
+
+  if (slotCount > capacity || newLength != length) {
+    const size_t chunks = (slotCount + CAPACITY_CHUNK - 1) / CAPACITY_CHUNK;
+    allocate(std::max<size_t>(chunks, 1) * CAPACITY_CHUNK, newLength);
+  }
+
+  slots = slotCount;
+  head = (head + 1) % length;
+  recordedFrames = std::min(recordedFrames + 1, length);
+
+  staging.resize(slots);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(slots); ++i) {
+    staging[i] = glm::vec2(instanceData[static_cast<size_t>(i) * 2]);
+  }
+
+  glBindBuffer(GL_TEXTURE_BUFFER, historyBuffer);
+  glBufferSubData(GL_TEXTURE_BUFFER, head * capacity * sizeof(glm::vec2),
+                  slots * sizeof(glm::vec2), staging.data());
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void TrailBuffer::render(const glm::mat4 &projection, GLuint particleInstanceVBO) const {
+  if (recordedFrames < 2 || slots == 0) {
+    return;
+  }
+
+  // Colour and active flag come straight from the particle instance buffer, one per strip
+  glBindVertexArray(trailVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, particleInstanceVBO);
+  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4), (void *)0);
+  glEnableVertexAttribArray(2);
+  glVertexAttribDivisor(2, 1);
+  glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4),
+                        (void *)(sizeof(glm::vec4)));
+  glEnableVertexAttribArray(3);
+  glVertexAttribDivisor(3, 1);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  trailShader->use();
+  trailShader->setMat4("projection", projection);
+  trailShader->setInt("uHistory", 0);
+  trailShader->setInt("uHead", head);
+  trailShader->setInt("uLength", length);
+  trailShader->setInt("uFrames", recordedFrames);
+  trailShader->setInt("uCapacity", static_cast<int>(capacity));
+  trailShader->setFloat("uBreakDistance", TRAIL_BREAK_DISTANCE);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_BUFFER, historyTexture);
+  glDrawArraysInstanced(GL_LINE_STRIP, 0, recordedFrames, static_cast<GLsizei>(slots));
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  glBindVertexArray(0);
+}
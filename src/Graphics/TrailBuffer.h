@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Graphics/shader.h"
+
+// GPU ring buffer holding the last K positions of every instance slot. One slice of K is
+// overwritten per frame, so trails cost a single position upload per particle regardless of
+// their length, and the whole history is drawn with one instanced line-strip call.
+class TrailBuffer {
+public:
+  static constexpr int MAX_LENGTH = 64;
+
+  TrailBuffer();
+  ~TrailBuffer();
+  TrailBuffer(const TrailBuffer &) = delete;
+  TrailBuffer &operator=(const TrailBuffer &) = delete;
+
+  // instanceData uses the particle layout: [x, y, radius, active] [r, g, b, pad] per slot
+  void record(const std::vector<glm::vec4> &instanceData, size_t slotCount, int length);
+  void render(const glm::mat4 &projection, GLuint particleInstanceVBO) const;
+  void reset();
+
+  [[nodiscard]] size_t getMemoryUsage() const { return capacity * length * sizeof(glm::vec2); }
+  [[nodiscard]] int getRecordedFrames() const { return recordedFrames; }
+
+private:
+  GLuint historyBuffer = 0;
+  GLuint historyTexture = 0;
+  GLuint trailVAO = 0;
+  std::unique_ptr<Shader> trailShader;
+  std::vector<glm::vec2> staging;
+
+  size_t capacity = 0;
+  size_t slots = 0;
+  int length = 0;
+  int head = 0;
+  int recordedFrames = 0;
+
+  void allocate(size_t newCapacity, int newLength);
+};
@@ -0,0 +1,173 @@
+#include "World.h"
+#include <algorithm>
+#include <glm/gtc/type_ptr.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include "Graphics/IntegrationKernel.h"
+
+template <int D> World<D>::World() { beta.fill(DEFAULT_BETA); }
+
+template <int D> void World<D>::setExtent(const Vec &newExtent) { extent = newExtent; }
+
+template <int D> void World<D>::setGridRegion(const Vec &origin, const Vec &regionExtent) {
+  gridOrigin = origin;
+  gridExtent = regionExtent;
+}
+
+template <int D> void World<D>::reserve(size_t capacity) {
+  positions.reserve(capacity);
+  velocities.reserve(capacity);
+  forces.reserve(capacity);
+  species.reserve(capacity);
+  indices.reserve(capacity);
+}
+
+template <int D> size_t World<D>::spawn(const Vec &pos, const Vec &vel, int type) {
+  positions.push_back(pos);
+  velocities.push_back(vel);
+  species.push_back(std::clamp(type, 0, MAX_SPECIES - 1));
+  return positions.size() - 1;
+}
+
+template <int D> void World<D>::spawnRandom(size_t count, int speciesCount, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> unit(-0.5F, 0.5F);
+  std::uniform_int_distribution<int> pick(0, std::clamp(speciesCount, 1, MAX_SPECIES) - 1);
+
+  reserve(positions.size() + count);
+  for (size_t n = 0; n < count; ++n) {
+    Vec pos;
+    for (int d = 0; d < D; ++d) {
+      pos[d] = unit(gen) * extent[d];
+    }
+    spawn(pos, Vec(0.0F), pick(gen));
+  }
+}
+
+template <int D> void World<D>::remove(size_t index) {
+  positions[index] = positions.back();
+  velocities[index] = velocities.back();
+  species[index] = species.back();
+  positions.pop_back();
+  velocities.pop_back();
+  species.pop_back();
+}
+
+template <int D> void World<D>::truncate(size_t count) {
+  if (count < positions.size()) {
+    positions.resize(count);
+    velocities.resize(count);
+    species.resize(count);
+  }
+}
+
+template <int D> void World<D>::clear() {
+  positions.clear();
+  velocities.clear();
+  forces.clear();
+  species.clear();
+  indices.clear();
+}
+
+template <int D> void World<D>::setInteraction(int a, int b, float strength) {
+  if (a >= 0 && a < MAX_SPECIES && b >= 0 && b < MAX_SPECIES) {
+    matrix[(a * MAX_SPECIES) + b] = strength;
+  }
+}
+
+template <int D> float World<D>::getInteraction(int a, int b) const {
+  if (a >= 0 && a < MAX_SPECIES && b >= 0 && b < MAX_SPECIES) {
+    return matrix[(a * MAX_SPECIES) + b];
+  }
+  return 0.0F;
+}
+
+template <int D> void World<D>::setInteractionMatrix(const float *values) {
+  std::copy(values, values + matrix.size(), matrix.begin());
+}
+
+template <int D> void World<D>::randomizeInteractions(int speciesCount, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-1.0F, 1.0F);
+  matrix.fill(0.0F);
+  const int n = std::clamp(speciesCount, 1, MAX_SPECIES);
+  for (int a = 0; a < n; ++a) {
+    for (int b = 0; b < n; ++b) {
+      matrix[(a * MAX_SPECIES) + b] = dist(gen);
+    }
+  }
+}
+
+template <int D> void World<D>::setSpeciesBeta(int type, float value) {
+  if (type >= 0 && type < MAX_SPECIES) {
+    beta[type] = std::clamp(value, 0.05F, 0.95F);
+  }
+}
+
+template <int D> void World<D>::step(float deltaTime) {
+  computeForces(positions.size());
+  integrate(deltaTime, positions.size());
+}
+
+template <int D> void World<D>::computeForces(size_t receivers) {
+  const size_t n = positions.size();
+  receivers = std::min(receivers, n);
+  forces.assign(n, Vec(0.0F));
+  if (receivers == 0) {
+    return;
+  }
+
+  const bool region = gridExtent != Vec(0.0F);
+  grid.resize(params.rMax, region ? gridOrigin : -extent * 0.5F, region ? gridExtent : extent, n);
+  cells.resize(n);
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < static_cast<int>(n); ++i) {
+    cells[i] = grid.cellOf(positions[i]);
+  }
+  grid.update(cells.data(), n);
+  const SpeciesInteraction interaction{matrix.data(), species.data()};
+
+  // Halo particles only send force, which the symmetric pair kernel cannot skip
+  if (receivers == n && pairKernelPays<D>(grid.getCellCount())) {
+    indices.resize(n);
+    std::iota(indices.begin(), indices.end(), 0);
+    accumulatePairForces(pairScratch, indices, positions.data(), species.data(), beta.data(),
+                         params.rMax, interaction, forces.data());
+    return;
+  }
+
+  if (tiledTraversal) {
+    grid.tileOrder(indices, receivers);
+  } else {
+    indices.resize(receivers);
+    std::iota(indices.begin(), indices.end(), 0);
+  }
+  accumulateGridForces(grid, indices, positions.data(), species.data(), beta.data(), params.rMax,
+                       interaction, forces.data());
+}
+
+template <int D> void World<D>::integrate(float deltaTime, size_t count) {
+  count = std::min(count, positions.size());
+  if (count == 0) {
+    return;
+  }
+  const Vec bound = params.bounded ? extent * 0.5F : Vec(std::numeric_limits<float>::max());
+  float *pos = glm::value_ptr(positions[0]);
+  float *vel = glm::value_ptr(velocities[0]);
+  const float *force = glm::value_ptr(forces[0]);
+
+  // Chunks start on a particle, so every call sees the bound pattern from component 0
+  constexpr size_t CHUNK = 4096;
+  const int chunks = static_cast<int>((count + CHUNK - 1) / CHUNK);
+#pragma omp parallel for schedule(static)
+  for (int c = 0; c < chunks; ++c) {
+    const size_t begin = static_cast<size_t>(c) * CHUNK;
+    const size_t offset = begin * D;
+    integrateArrays(pos + offset, vel + offset, force + offset, std::min(CHUNK, count - begin), D,
+                    glm::value_ptr(bound), deltaTime, params.friction, params.bounce);
+  }
+}
+
+template class World<2>;
+template class World<3>;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Graphics/ForceKernel.h"
+#include "Graphics/SpatialGrid.h"
+
+// Everything a World step reads; a world never touches the simulation globals
+struct WorldParams {
+  float rMax = 60.0F;
+  float friction = 0.70710678F; // share of velocity kept per step
+  float bounce = 0.9F;          // speed kept when reflecting off the box
+  bool bounded = true;
+};
+
+// Particle life on plain structure-of-arrays storage, templated on dimension. It shares the
+// grid and force kernels with ParticleSystem but owns no GL state, so the same engine backs the
+// 3D mode and anything that drives the simulation without a window. The box is centred on the
+// origin. Particles are dense: there is no inactive state, removal swaps in the last particle.
+template <int D> class World {
+public:
+  using Vec = glm::vec<D, float>;
+  static constexpr int MAX_SPECIES = SpeciesInteraction::MAX_TYPES;
+
+  World();
+
+  void setExtent(const Vec &extent);
+  // Restricts the neighbour grid to part of the box, e.g. one rank's slab plus its halo
+  void setGridRegion(const Vec &origin, const Vec &extent);
+  void reserve(size_t capacity);
+  size_t spawn(const Vec &pos, const Vec &vel, int species);
+  void spawnRandom(size_t count, int speciesCount, uint32_t seed);
+  void remove(size_t index);
+  void truncate(size_t count);
+  void clear();
+
+  void step(float deltaTime);
+  // The two halves of step(): forces on the first receivers from every particle, then
+  // integration of the first count particles
+  void computeForces(size_t receivers);
+  void integrate(float deltaTime, size_t count);
+
+  void setInteraction(int a, int b, float strength);
+  [[nodiscard]] float getInteraction(int a, int b) const;
+  void setInteractionMatrix(const float *values); // MAX_SPECIES x MAX_SPECIES, row = receiver
+  void randomizeInteractions(int speciesCount, uint32_t seed);
+  void setSpeciesBeta(int species, float beta);
+
+  [[nodiscard]] WorldParams &getParams() { return params; }
+  [[nodiscard]] const WorldParams &getParams() const { return params; }
+  [[nodiscard]] Vec getExtent() const { return extent; }
+  [[nodiscard]] size_t size() const { return positions.size(); }
+  [[nodiscard]] bool empty() const { return positions.empty(); }
+
+  [[nodiscard]] const Vec *getPositions() const { return positions.data(); }
+  [[nodiscard]] const Vec *getVelocities() const { return velocities.data(); }
+  [[nodiscard]] const int *getSpecies() const { return species.data(); }
+  [[nodiscard]] Vec *getPositions() { return positions.data(); }
+  [[nodiscard]] Vec *getVelocities() { return velocities.data(); }
+
+  [[nodiscard]] const SpatialGridND<D> &getGrid() const { return grid; }
+  // Steps between full rebuilds of the incrementally maintained neighbour grid
+  void setGridRebuildInterval(int steps) { grid.setRebuildInterval(steps); }
+  // Receivers traversed cell by cell along a Hilbert curve (default) or in index order
+  void setTiledTraversal(bool enabled) { tiledTraversal = enabled; }
+
+private:
+  WorldParams params;
+  Vec extent{1000.0F};
+  Vec gridOrigin{0.0F};
+  Vec gridExtent{0.0F}; // zero means the whole box
+  bool tiledTraversal = true;
+  std::vector<Vec> positions;
+  std::vector<Vec> velocities;
+  std::vector<Vec> forces;
+  std::vector<int> species;
+  std::vector<size_t> indices;
+  std::vector<int> cells;
+  std::array<float, MAX_SPECIES * MAX_SPECIES> matrix{};
+  std::array<float, MAX_SPECIES> beta{};
+  SpatialGridND<D> grid;
+  PairForceScratch<D> pairScratch;
+};
+
+using World2D = World<2>;
+using World3D = World<3>;
@@ -1,5 +1,7 @@
 #include "renderer.h"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <glm/gtc/matrix_transform.hpp>
 
 Renderer::Renderer() { init(); }
@@ -12,6 +14,10 @@ void Renderer::init() {
   setupRectBuffer();
   setupCircleBuffer();
   setupLineBuffer();
+
+  batchShader = std::make_unique<Shader>("../../../../src/Graphics/shaders/batch2D.vert",
+                                         "../../../../src/Graphics/shaders/batch2D.frag");
+  setupBatchBuffer();
 }
 
 void Renderer::setupRectBuffer() {
@@ -72,6 +78,36 @@ void Renderer::setupLineBuffer() {
   glBindVertexArray(0);
 }
 
+void Renderer::setupBatchBuffer() {
+  glGenVertexArrays(1, &batchVAO);
+  glGenBuffers(1, &batchVBO);
+
+  glBindVertexArray(batchVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, batchVBO);
+
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex2D),
+                        (void *)offsetof(Vertex2D, position));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex2D), (void *)offsetof(Vertex2D, color));
+  glEnableVertexAttribArray(1);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+void Renderer::uploadBatch(const std::vector<Vertex2D> &vertices) {
+  glBindBuffer(GL_ARRAY_BUFFER, batchVBO);
+  const size_t bytes = vertices.size() * sizeof(Vertex2D);
+
+  // Grow geometrically and orphan the old storage instead of reallocating every frame
+  if (bytes > batchCapacity) {
+    batchCapacity = std::max(bytes, batchCapacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, batchCapacity, nullptr, GL_STREAM_DRAW);
+  }
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void Renderer::render() {
   // This is a placeholder - rendering will be done by individual draw calls
 }
@@ -170,4 +206,36 @@ void Renderer::drawLine(float x1, float y1, float x2, float y2, const glm::vec3
 
   // Reset line width to default
   glLineWidth(1.0F);
+}
+
+void Renderer::drawLines(const std::vector<Vertex2D> &vertices, float thickness) {
+  if (vertices.empty()) {
+    return;
+  }
+
+  uploadBatch(vertices);
+
+  batchShader->use();
+  batchShader->setMat4("projection", projectionMatrix);
+
+  glBindVertexArray(batchVAO);
+  glLineWidth(thickness);
+  glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+  glLineWidth(1.0F);
+  glBindVertexArray(0);
+}
+
+void Renderer::drawTriangles(const std::vector<Vertex2D> &vertices) {
+  if (vertices.empty()) {
+    return;
+  }
+
+  uploadBatch(vertices);
+
+  batchShader->use();
+  batchShader->setMat4("projection", projectionMatrix);
+
+  glBindVertexArray(batchVAO);
+  glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+  glBindVertexArray(0);
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 #include "shader.h"
 
+struct Vertex2D {
+  glm::vec2 position;
+  glm::vec4 color;
+};
+
 class Renderer {
 public:
   Renderer();
@@ -10,21 +16,31 @@ public:
   void render();
 
   void setProjectionMatrix(const glm::mat4 &projection) { projectionMatrix = projection; }
+  [[nodiscard]] const glm::mat4 &getProjectionMatrix() const { return projectionMatrix; }
 
   void drawRect(float x, float y, float width, float height, const glm::vec3 &color);
   void drawCircle(float x, float y, float radius, const glm::vec3 &color, int segments = 32);
   void drawLine(float x1, float y1, float x2, float y2, const glm::vec3 &color,
                 float thickness = 1.0F);
 
+  // Batched path: one upload and one draw call for many primitives with per-vertex colour
+  void drawLines(const std::vector<Vertex2D> &vertices, float thickness = 1.0F);
+  void drawTriangles(const std::vector<Vertex2D> &vertices);
+
 private:
   std::unique_ptr<Shader> shader2D;
   unsigned int rectVAO, rectVBO;
   unsigned int circleVAO, circleVBO;
   unsigned int lineVAO, lineVBO;
+  std::unique_ptr<Shader> batchShader;
+  unsigned int batchVAO, batchVBO;
+  size_t batchCapacity = 0;
   glm::mat4 projectionMatrix{1.0F};
 
   // Helper methods to set up buffers
   void setupRectBuffer();
   void setupCircleBuffer();
   void setupLineBuffer();
+  void setupBatchBuffer();
+  void uploadBatch(const std::vector<Vertex2D> &vertices);
 };
\ No newline at end of file
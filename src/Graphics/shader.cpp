@@ -32,6 +32,10 @@ void Shader::setFloat(std::string_view name, float value) const {
   glUniform1f(getUniformLocation(name), value);
 }
 
+void Shader::setVec2(std::string_view name, const glm::vec2 &value) const {
+  glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
+}
+
 void Shader::setVec3(std::string_view name, const glm::vec3 &value) const {
   glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
@@ -15,6 +15,7 @@ public:
   void setBool(std::string_view name, bool v) const;
   void setInt(std::string_view name, int v) const;
   void setFloat(std::string_view name, float v) const;
+  void setVec2(std::string_view name, glm::vec2 const &v) const;
   void setVec3(std::string_view name, glm::vec3 const &v) const;
   void setMat4(std::string_view name, glm::mat4 const &m) const;
   GLuint getProgramID() const { return programID; }
@@ -0,0 +1,12 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D layer; // premultiplied colour
+uniform vec2 uvMax;
+
+void main()
+{
+    FragColor = texture(layer, min(TexCoord, uvMax));
+}
@@ -0,0 +1,13 @@
+#version 410 core
+
+out vec2 TexCoord;
+
+uniform vec2 uvScale; // share of the texture the layer was drawn into
+
+void main()
+{
+    // One triangle covering the viewport, corners from the vertex index
+    vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    TexCoord = corner * uvScale;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
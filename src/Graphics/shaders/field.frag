@@ -0,0 +1,29 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D fieldTexture; // r = density, gb = mean velocity
+uniform float invMaxDensity;
+
+// Compact polynomial fit of the viridis colour map
+vec3 viridis(float t) {
+    const vec3 c0 = vec3(0.2777, 0.0054, 0.3341);
+    const vec3 c1 = vec3(0.1051, 1.4046, 1.3846);
+    const vec3 c2 = vec3(-0.3309, 0.2148, 0.0951);
+    const vec3 c3 = vec3(-4.6342, -5.7991, -19.3324);
+    const vec3 c4 = vec3(6.2283, 14.1799, 56.6906);
+    const vec3 c5 = vec3(4.7764, -13.7451, -65.3530);
+    const vec3 c6 = vec3(-5.4355, 4.6459, 26.3124);
+    return c0 + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * (c5 + t * c6)))));
+}
+
+void main()
+{
+    float density = texture(fieldTexture, TexCoord).r * invMaxDensity;
+    if (density <= 0.0)
+        discard;
+
+    float t = sqrt(clamp(density, 0.0, 1.0));
+    FragColor = vec4(viridis(t), 0.25 + 0.5 * t);
+}
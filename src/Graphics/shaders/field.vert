@@ -0,0 +1,14 @@
+#version 410 core
+layout (location = 0) in vec2 aPos; // unit quad corner
+
+out vec2 TexCoord;
+
+uniform mat4 projection;
+uniform vec2 gridOrigin;
+uniform vec2 gridExtent;
+
+void main()
+{
+    TexCoord = aPos;
+    gl_Position = projection * vec4(gridOrigin + aPos * gridExtent, 0.0, 1.0);
+}
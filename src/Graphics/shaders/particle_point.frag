@@ -0,0 +1,22 @@
+#version 410 core
+
+in vec4 Color;
+in float Active;
+out vec4 FragColor;
+
+// particle.frag with the sprite coordinate in place of the quad's texture coordinate
+void main() {
+    if (Active < 0.5)
+        discard;
+
+    float dist = length(gl_PointCoord - vec2(0.5, 0.5)) * 2.0;
+    if (dist > 1.0)
+        discard;
+
+    vec3 innerColor = Color.rgb * 1.3;
+    vec3 outerColor = Color.rgb * 0.7;
+    vec3 finalColor = mix(innerColor, outerColor, dist);
+    float alpha = 1.0 - smoothstep(0.8, 1.0, dist);
+
+    FragColor = vec4(finalColor, alpha * Color.a);
+}
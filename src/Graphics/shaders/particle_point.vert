@@ -0,0 +1,18 @@
+#version 410 core
+layout (location = 2) in vec4 aInstanceData; // x, y, radius, active
+layout (location = 3) in vec4 aColor;        // r, g, b, padding
+
+out vec4 Color;
+out float Active;
+
+uniform mat4 projection;
+uniform float pixelsPerUnit; // viewport pixels per world unit
+
+void main()
+{
+    Active = aInstanceData.w;
+    gl_Position = projection * vec4(aInstanceData.xy, 0.0, 1.0);
+    // Points are clipped by their centre, so sprites pop at the viewport edge
+    gl_PointSize = Active < 0.5 ? 0.0 : aInstanceData.z * pixelsPerUnit;
+    Color = vec4(aColor.rgb, 1.0);
+}
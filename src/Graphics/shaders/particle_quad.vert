@@ -0,0 +1,25 @@
+#version 410 core
+layout (location = 2) in vec4 aInstanceData; // x, y, radius, active
+layout (location = 3) in vec4 aColor;        // r, g, b, padding
+
+out vec2 TexCoord;
+out vec4 Color;
+out float Active;
+
+uniform mat4 projection;
+
+void main()
+{
+    // Triangle strip corners from the vertex index: (0,0) (1,0) (0,1) (1,1)
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    vec2 position = aInstanceData.xy;
+    float radius = aInstanceData.z;
+    Active = aInstanceData.w;
+
+    // Same extent as the indexed quad: a side of one radius around the position
+    vec2 pos = (corner - 0.5) * radius + position;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+
+    TexCoord = corner;
+    Color = vec4(aColor.rgb, 1.0);
+}
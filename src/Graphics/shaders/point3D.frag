@@ -0,0 +1,19 @@
+#version 410 core
+
+in vec3 Color;
+out vec4 FragColor;
+
+void main()
+{
+    // Shade the sprite as a sphere lit from the viewer's upper left
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    float distSqr = dot(offset, offset);
+    if (distSqr > 1.0)
+        discard;
+
+    vec3 normal = vec3(offset.x, -offset.y, sqrt(1.0 - distSqr));
+    float diffuse = max(dot(normal, normalize(vec3(-0.4, 0.5, 0.8))), 0.0);
+    vec3 finalColor = Color * (0.35 + 0.75 * diffuse);
+
+    FragColor = vec4(finalColor, 1.0);
+}
@@ -0,0 +1,20 @@
+#version 410 core
+layout (location = 0) in vec4 aPoint; // x, y, z, species
+
+out vec3 Color;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float pointScale;
+uniform vec3 palette[16];
+uniform int paletteSize;
+
+void main()
+{
+    vec4 viewPos = view * vec4(aPoint.xyz, 1.0);
+    gl_Position = projection * viewPos;
+    gl_PointSize = max(pointScale / max(-viewPos.z, 1.0), 1.0);
+
+    int species = clamp(int(aPoint.w), 0, paletteSize - 1);
+    Color = palette[species];
+}
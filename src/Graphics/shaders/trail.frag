@@ -0,0 +1,11 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec4 Color;
+
+void main()
+{
+    if (Color.a <= 0.0)
+        discard;
+    FragColor = Color;
+}
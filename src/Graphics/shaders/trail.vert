@@ -0,0 +1,37 @@
+#version 410 core
+layout (location = 2) in vec4 aInstanceData; // x, y, radius, active
+layout (location = 3) in vec4 aColor;        // r, g, b, padding
+
+out vec4 Color;
+
+uniform mat4 projection;
+uniform samplerBuffer uHistory; // uLength slices of uCapacity positions
+uniform int uHead;
+uniform int uLength;
+uniform int uFrames;
+uniform int uCapacity;
+uniform float uBreakDistance;
+
+vec2 historyAt(int age)
+{
+    int frame = (uHead - age + uLength) % uLength;
+    return texelFetch(uHistory, frame * uCapacity + gl_InstanceID).xy;
+}
+
+void main()
+{
+    // Vertex 0 is the newest sample, the strip walks back in time
+    int age = gl_VertexID;
+    vec2 position = historyAt(age);
+
+    float alpha = (1.0 - float(age) / float(uFrames)) * 0.6 * step(0.5, aInstanceData.w);
+
+    // Hide segments that jump, so a reused instance slot does not draw a line across the box
+    if (age > 0 && distance(position, historyAt(age - 1)) > uBreakDistance)
+        alpha = 0.0;
+    if (age + 1 < uFrames && distance(position, historyAt(age + 1)) > uBreakDistance)
+        alpha = 0.0;
+
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+    Color = vec4(aColor.rgb, alpha);
+}
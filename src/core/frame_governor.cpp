@@ -0,0 +1,85 @@
+#include "frame_governor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Weight of the newest sample in the smoothed costs
+constexpr float SMOOTHING = 0.1F;
+// Drawing must take this share of the budget before the reduced mode is considered
+constexpr float RENDER_SHARE = 0.5F;
+// Consecutive over-budget frames before drawing is reduced, so one hitch does not switch modes
+constexpr int DEGRADE_FRAMES = 30;
+// Full drawing comes back once a step and a full draw fit this share of the budget
+constexpr float RESTORE_SHARE = 0.8F;
+// Fewest particles drawn, as a share of the visible ones; the radius grows by up to 1/sqrt of it
+constexpr float MIN_KEEP_RATIO = 0.1F;
+// Frames between keep ratio changes, so the smoothed draw cost catches up with the last one
+constexpr int KEEP_SETTLE_FRAMES = 10;
+// Growth per change once drawing fits again; slow, so the ratio does not swing back and forth
+constexpr float KEEP_GROWTH = 1.1F;
+
+float smooth(float average, float sample) {
+  return average == 0.0F ? sample : average + (SMOOTHING * (sample - average));
+}
+} // namespace
+
+int FrameGovernor::plan(float simSeconds, float targetMs, int maxSubSteps) {
+  maxSubSteps = std::max(1, maxSubSteps);
+  const int wanted = std::max(1, static_cast<int>(std::ceil(simSeconds / MAX_STEP_SECONDS)));
+
+  int affordable = maxSubSteps;
+  if (stepMs > 0.0F) {
+    affordable = static_cast<int>((targetMs - renderMs) / stepMs);
+    affordable = std::clamp(affordable, 1, maxSubSteps);
+  }
+
+  const int steps = std::min(wanted, affordable);
+  stepDelta = std::min(simSeconds / static_cast<float>(steps), MAX_STEP_SECONDS);
+  simRate = simSeconds > 0.0F ? std::min(1.0F, stepDelta * steps / simSeconds) : 1.0F;
+
+  if (!renderReduced) {
+    const bool drawBound = drawMs() > RENDER_SHARE * targetMs && stepMs + drawMs() > targetMs;
+    overBudgetFrames = drawBound ? overBudgetFrames + 1 : 0;
+    if (overBudgetFrames >= DEGRADE_FRAMES) {
+      renderReduced = true;
+      fullRenderMs = drawMs();
+      overBudgetFrames = 0;
+    }
+  } else if (stepMs + fullRenderMs < RESTORE_SHARE * targetMs) {
+    // The step got cheaper, e.g. fewer particles, so the full draw fits again
+    renderReduced = false;
+    renderMs = fullRenderMs;
+  }
+  return steps;
+}
+
+float FrameGovernor::planKeepRatio(float targetMs) {
+  if (!renderReduced) {
+    keepRatio = 1.0F;
+    keepSettleFrames = 0;
+    return keepRatio;
+  }
+  if (++keepSettleFrames < KEEP_SETTLE_FRAMES) {
+    return keepRatio;
+  }
+
+  // Drawing cost is close to linear in the particles drawn, so scale the share by the overrun;
+  // at most halve it per change in case a fixed cost dominates
+  const float drawBudget = RENDER_SHARE * targetMs;
+  const float drawCost = drawMs();
+  if (drawCost > drawBudget) {
+    keepRatio *= std::max(0.5F, drawBudget / drawCost);
+    keepRatio = std::max(keepRatio, MIN_KEEP_RATIO);
+    keepSettleFrames = 0;
+  } else if (drawCost < RESTORE_SHARE * drawBudget && keepRatio < 1.0F) {
+    keepRatio = std::min(1.0F, keepRatio * KEEP_GROWTH);
+    keepSettleFrames = 0;
+  }
+  return keepRatio;
+}
+
+float FrameGovernor::drawMs() const { return std::max(renderMs, gpuMs); }
+
+void FrameGovernor::recordStep(float ms) { stepMs = smooth(stepMs, ms); }
+
+void FrameGovernor::recordRender(float ms) { renderMs = smooth(renderMs, ms); }
@@ -0,0 +1,48 @@
+#pragma once
+
+// Holds the frame time to a target by deciding how many simulation steps each displayed frame
+// runs and whether drawing drops to a cheaper mode. The caller times every step and every draw;
+// the costs are smoothed here and the next frame is planned from them. A frame never owes more
+// steps than fit the budget: under load the simulation runs slower than requested instead of
+// the frame rate collapsing under an ever longer backlog.
+class FrameGovernor {
+public:
+  // Largest time step a single step may take, the stability bound the main loop always clamped to
+  static constexpr float MAX_STEP_SECONDS = 0.05F;
+
+  // Plans a frame that owes simSeconds of simulated time; returns the number of steps to run,
+  // each getStepDelta() long
+  int plan(float simSeconds, float targetMs, int maxSubSteps);
+  [[nodiscard]] float getStepDelta() const { return stepDelta; }
+  // Simulated time the last plan covers, as a share of what the frame owed
+  [[nodiscard]] float getSimRate() const { return simRate; }
+
+  void recordStep(float ms);
+  // CPU time of a draw, from its start to the buffer swap
+  void recordRender(float ms);
+  // GPU time of the particle pass, 0 when it was not drawn or cannot be timed. A GPU-bound draw
+  // returns quickly on the CPU, so the reduced mode and the keep ratio go by the larger of the two.
+  void recordGpu(float ms) { gpuMs = ms; }
+  [[nodiscard]] float getStepMs() const { return stepMs; }
+  [[nodiscard]] float getRenderMs() const { return renderMs; }
+
+  // Trails and overlays are skipped while drawing alone would overrun the budget
+  [[nodiscard]] bool isRenderReduced() const { return renderReduced; }
+  // Share of the visible particles to draw. Lowered only in the reduced mode, while drawing
+  // still takes more than its share of the budget; 1 otherwise
+  float planKeepRatio(float targetMs);
+
+private:
+  [[nodiscard]] float drawMs() const;
+
+  float stepMs = 0.0F;
+  float renderMs = 0.0F;
+  float gpuMs = 0.0F;        // already smoothed by the timer that measured it
+  float fullRenderMs = 0.0F; // draw cost when the reduced mode was entered
+  float stepDelta = MAX_STEP_SECONDS;
+  float simRate = 1.0F;
+  int overBudgetFrames = 0;
+  bool renderReduced = false;
+  float keepRatio = 1.0F;
+  int keepSettleFrames = 0; // frames since keepRatio last changed
+};
@@ -14,6 +14,7 @@ Window::Window(const char *title, const int width, const int height) {
   SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
   SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
   SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
   window =
       SDL_CreateWindow(windowTitle.c_str(), width, height,
@@ -43,14 +44,35 @@ Window::~Window() {
 
 void Window::swapBuffers() const { SDL_GL_SwapWindow(window); }
 
-void Window::pollEvents() {
+void Window::handleEvent(const SDL_Event &event) {
+  ImGui_ImplSDL3_ProcessEvent(&event);
+  if (event.type == SDL_EVENT_QUIT) {
+    isRunning = false;
+  }
+}
+
+bool Window::pollEvents() {
+  bool any = false;
   SDL_Event event;
   while (SDL_PollEvent(&event)) {
-    ImGui_ImplSDL3_ProcessEvent(&event);
-    if (event.type == SDL_EVENT_QUIT) {
-      isRunning = false;
-    }
+    handleEvent(event);
+    any = true;
   }
+  return any;
+}
+
+bool Window::waitEvents(int timeoutMs) {
+  SDL_Event event;
+  if (!SDL_WaitEventTimeout(&event, timeoutMs)) {
+    return false;
+  }
+  handleEvent(event);
+  pollEvents();
+  return true;
+}
+
+bool Window::isHidden() const {
+  return (SDL_GetWindowFlags(window) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_OCCLUDED)) != 0;
 }
 
 bool Window::shouldClose() const { return !isRunning; }
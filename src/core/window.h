@@ -10,13 +10,19 @@ public:
   void swapBuffers() const;
   bool shouldClose() const;
 
-  void pollEvents();
+  // Both return whether any event arrived; waitEvents sleeps until one does or the timeout ends
+  bool pollEvents();
+  bool waitEvents(int timeoutMs);
+  // Minimized or fully covered, so nothing drawn would be seen
+  bool isHidden() const;
   SDL_Window *getSDLWindow() const;
   SDL_GLContext getGLContext() const;
 
   void updateTitle(float fps);
 
 private:
+  void handleEvent(const SDL_Event &event);
+
   SDL_Window *window = nullptr;
   SDL_GLContext glContext = nullptr;
   bool isRunning = true;
@@ -3,22 +3,35 @@
 #include <backends/imgui_impl_opengl3.h>
 #include <backends/imgui_impl_sdl3.h>
 #include <chrono>
+#include <cmath>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <imgui.h>
 #include <iostream>
 #include "Common.h"
 #include "GUI/gui.h"
+#include "Graphics/Camera2D.h"
+#include "Graphics/CommandQueue.h"
 #include "Graphics/ParticleSystem.h"
+#include "Graphics/ScaledRenderTarget.h"
 #include "Graphics/Simulation.h"
 #include "Graphics/renderer.h"
 #include "core/fps_counter.h"
+#include "core/frame_governor.h"
 #include "core/window.h"
 
 // Constants
 const int NUM_PARTICLE_TYPES = 4;
 const int PARTICLES_PER_EMIT = 100;
 const float PARTICLE_RADIUS = 4.0F;
+// Frames still drawn after the last input, so hover and click feedback settles in ImGui
+const int SETTLE_FRAMES = 3;
+// Longest sleep while paused and idle; bounds how stale the window title can get
+const int IDLE_WAIT_MS = 500;
+// Step pacing while the window is hidden and vsync no longer throttles the loop
+const float HIDDEN_STEP_SECONDS = 1.0F / 60.0F;
+// Share of the frame budget the particle pass may take on the GPU before its resolution drops
+const float PARTICLE_GPU_SHARE = 0.5F;
 
 // Global variables
 bool paused = false;
@@ -66,9 +79,9 @@ int main() {
       projectionHeight = projectionWidth / currentAspectRatio;
     }
 
-    glm::mat4 projection =
-        glm::ortho(-projectionWidth / 2.0F, projectionWidth / 2.0F, -projectionHeight / 2.0F,
-                   projectionHeight / 2.0F, -1.0F, 1.0F);
+    Camera2D camera;
+    camera.setFrame({projectionWidth, projectionHeight});
+    glm::mat4 projection = camera.getProjection(simulation::view2D);
     renderer.setProjectionMatrix(projection);
 
     glClearColor(glBackgroundColour.r, glBackgroundColour.g, glBackgroundColour.b,
@@ -77,6 +90,8 @@ int main() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     FpsCounter fpsCounter;
+    FrameGovernor frameGovernor;
+    ScaledRenderTarget particleLayer;
 
     auto lastFrameTime = std::chrono::high_resolution_clock::now();
 
@@ -86,40 +101,160 @@ int main() {
       ParticleSystem::randomizeInteractions();
     }
 
-    // Main loop
+    int settleFrames = SETTLE_FRAMES;
+
+    // Main loop. Frames are drawn while the simulation runs, and while paused only on input or
+    // when particles changed; a paused idle window sleeps in the event queue. A hidden window
+    // keeps stepping without drawing.
     while (!window.shouldClose()) {
+      const bool idle = paused && (window.isHidden() ||
+                                   (settleFrames == 0 && !Particle::instancesDirty()));
+      if (idle ? window.waitEvents(IDLE_WAIT_MS) : window.pollEvents()) {
+        settleFrames = SETTLE_FRAMES;
+      }
+      // Commands a full queue held back last frame go out ahead of this frame's
+      simulation::commands().flush();
+
       auto currentFrameTime = std::chrono::high_resolution_clock::now();
       float rawDeltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
       lastFrameTime = currentFrameTime;
 
-      float deltaTime = std::min(rawDeltaTime * simulation::simulationSpeed, 0.05F);
-
-      window.pollEvents();
+      const float owedTime = rawDeltaTime * simulation::simulationSpeed;
+      float deltaTime = std::min(owedTime, FrameGovernor::MAX_STEP_SECONDS);
+
+      const bool draw =
+          !window.isHidden() && (!paused || settleFrames > 0 || Particle::instancesDirty());
+      if (!draw) {
+        if (!paused) {
+          particleSystem->update(deltaTime);
+          const float spent = std::chrono::duration<float>(
+                                  std::chrono::high_resolution_clock::now() - currentFrameTime)
+                                  .count();
+          if (spent < HIDDEN_STEP_SECONDS) {
+            SDL_Delay(static_cast<Uint32>((HIDDEN_STEP_SECONDS - spent) * 1000.0F));
+          }
+        }
+        continue;
+      }
 
       ImGui_ImplOpenGL3_NewFrame();
       ImGui_ImplSDL3_NewFrame();
       ImGui::NewFrame();
 
       gui::RenderGui(fpsCounter);
+      if (!io.WantCaptureKeyboard && ImGui::IsKeyPressed(ImGuiKey_Space, false)) {
+        paused = !paused;
+      }
+      if (simulation::dimensions == 2 && !io.WantCaptureMouse) {
+        const glm::vec2 screenSize(io.DisplaySize.x, io.DisplaySize.y);
+        const glm::vec2 mouse(io.MousePos.x, io.MousePos.y);
+        simulation::View2D view = simulation::view2D;
+        bool moved = false;
+        if (io.MouseWheel != 0.0F) {
+          view = camera.zoomedAt(view, mouse, screenSize, std::pow(1.1F, io.MouseWheel));
+          moved = true;
+        }
+        if ((ImGui::IsMouseDown(ImGuiMouseButton_Right) ||
+             ImGui::IsMouseDown(ImGuiMouseButton_Middle)) &&
+            (io.MouseDelta.x != 0.0F || io.MouseDelta.y != 0.0F)) {
+          view = camera.panned(view, {io.MouseDelta.x, io.MouseDelta.y}, screenSize);
+          moved = true;
+        }
+        if (moved) {
+          simulation::commands().set(simulation::view2D, view);
+        }
+      }
 
+      // GUI changes queued this frame land here, between steps
       if (!paused) {
-        particleSystem->update(deltaTime);
+        const simulation::GovernorSettings &budget = simulation::governor;
+        int subSteps = 1;
+        if (budget.enabled) {
+          subSteps = frameGovernor.plan(owedTime, budget.targetMs, budget.maxSubSteps);
+          deltaTime = frameGovernor.getStepDelta();
+        }
+        for (int step = 0; step < subSteps; ++step) {
+          const auto stepStart = std::chrono::high_resolution_clock::now();
+          particleSystem->update(deltaTime);
+          frameGovernor.recordStep(std::chrono::duration<float, std::milli>(
+                                       std::chrono::high_resolution_clock::now() - stepStart)
+                                       .count());
+        }
+
+        simulation::GovernorStats &stats = simulation::governorStats;
+        stats.subSteps = subSteps;
+        stats.stepMs = frameGovernor.getStepMs();
+        stats.renderMs = frameGovernor.getRenderMs();
+        stats.simRate = budget.enabled ? frameGovernor.getSimRate()
+                                       : std::min(1.0F, deltaTime / std::max(owedTime, 1e-6F));
+        stats.reducedRender = budget.enabled && frameGovernor.isRenderReduced();
+        stats.keepRatio =
+            budget.enabled && budget.decimate ? frameGovernor.planKeepRatio(budget.targetMs) : 1.0F;
+        Particle::setKeepRatio(stats.keepRatio);
+      } else {
+        particleSystem->applyCommands();
       }
 
+      // CPU-side cost of the draw; waiting for the GPU here would serialise the two
+      const auto renderStart = std::chrono::high_resolution_clock::now();
+
+      // The drawable follows the window in pixels, which on high-density displays is larger
+      int pixelWidth = 0;
+      int pixelHeight = 0;
+      SDL_GetWindowSizeInPixels(window.getSDLWindow(), &pixelWidth, &pixelHeight);
+      glViewport(0, 0, pixelWidth, pixelHeight);
+
       // Set and clear background color
       glClearColor(glBackgroundColour.r, glBackgroundColour.g, glBackgroundColour.b,
                    glBackgroundColour.a);
-      glClear(GL_COLOR_BUFFER_BIT);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
       ImGui::Render();
 
-      ParticleSystem::render(projection);
+      projection = camera.getProjection(simulation::view2D);
+      renderer.setProjectionMatrix(projection);
+
+      bool particleLayerDrawn = false;
+      if (simulation::dimensions == 3) {
+        particleSystem->render3D(renderer);
+      } else {
+        particleSystem->renderUnderlays(renderer);
+        if (!simulation::showFieldOverlay || !simulation::hideParticlesUnderOverlay) {
+          particleLayerDrawn = true;
+          particleSystem->cullInstances(camera.visibleMin(simulation::view2D),
+                                        camera.visibleMax(simulation::view2D));
+          // Fill rate bound on large displays: drawn at a scale that follows its GPU time
+          particleLayer.begin(pixelWidth, pixelHeight);
+          ParticleSystem::render(projection);
+          particleLayer.end();
+        }
+        if (!simulation::governorStats.reducedRender) {
+          particleSystem->renderOverlays(renderer);
+        }
+      }
+      if (simulation::governor.enabled && simulation::governor.dynamicResolution) {
+        particleLayer.adapt(simulation::governor.targetMs * PARTICLE_GPU_SHARE);
+      } else {
+        particleLayer.resetScale();
+      }
+      simulation::governorStats.particleGpuMs = particleLayer.getGpuMs();
+      // Decimation thins the particle pass, so it answers to that pass's GPU time as well
+      frameGovernor.recordGpu(particleLayerDrawn ? particleLayer.getGpuMs() : 0.0F);
+      simulation::governorStats.renderScale = particleLayer.getScale();
+      // Uploads what an overlay or the 3D view kept from being drawn, so it reads as shown
+      Particle::updateAllInstanceData();
 
       ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+      frameGovernor.recordRender(std::chrono::duration<float, std::milli>(
+                                     std::chrono::high_resolution_clock::now() - renderStart)
+                                     .count());
       window.swapBuffers();
 
       float currentFps = fpsCounter.update();
       window.updateTitle(currentFps);
+      if (settleFrames > 0) {
+        --settleFrames;
+      }
     }
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,229 @@
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Distributed/DistributedWorld.h"
+#include "Distributed/Transport.h"
+
+// Headless distributed runner. Without --rank it forks --ranks local processes itself, over
+// shared memory by default or over loopback TCP with --transport tcp. With --rank it runs a
+// single rank, which is how multi-host runs are started: one process per host, the same
+// --endpoints list everywhere.
+
+namespace {
+
+struct Options {
+  int ranks = 4;
+  int rank = -1;
+  std::string transport = "shm";
+  std::vector<std::string> endpoints;
+  int basePort = 47000;
+  size_t particles = 200000;
+  int species = 6;
+  int steps = 600;
+  int reportEvery = 60;
+  uint32_t seed = 1;
+  float width = 8000.0F;
+  float height = 8000.0F;
+  float deltaTime = 0.05F;
+  float rebalanceThreshold = 1.15F;
+  int rebalanceEvery = 20;
+  bool tiledTraversal = true;
+  std::string segment;
+};
+
+std::vector<std::string> split(const std::string &text, char separator) {
+  std::vector<std::string> parts;
+  std::stringstream stream(text);
+  std::string part;
+  while (std::getline(stream, part, separator)) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+void printUsage() {
+  std::cout << "Usage: particle_life_node [options]\n"
+               "  --ranks N           local processes to fork (default 4)\n"
+               "  --rank R            run only rank R; needs --endpoints for tcp\n"
+               "  --transport shm|tcp communication backend (default shm)\n"
+               "  --endpoints LIST    comma separated host:port per rank\n"
+               "  --port P            first loopback port for local tcp runs (default 47000)\n"
+               "  --segment NAME      shared memory segment name for shm runs\n"
+               "  --particles N       total particles over all ranks\n"
+               "  --species N         number of species\n"
+               "  --steps N           steps to run\n"
+               "  --report N          print timings every N steps\n"
+               "  --size W H          box size\n"
+               "  --dt T              time step\n"
+               "  --seed S            random seed\n"
+               "  --rebalance T       recut domains past this imbalance, 0 disables (1.15)\n"
+               "  --rebalance-every N steps between imbalance checks (default 20)\n"
+               "  --traversal MODE    tiles (Hilbert cell blocks, default) or index\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--ranks" && hasValue) {
+      options.ranks = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--rank" && hasValue) {
+      options.rank = std::atoi(argv[++i]);
+    } else if (arg == "--transport" && hasValue) {
+      options.transport = argv[++i];
+    } else if (arg == "--endpoints" && hasValue) {
+      options.endpoints = split(argv[++i], ',');
+    } else if (arg == "--port" && hasValue) {
+      options.basePort = std::atoi(argv[++i]);
+    } else if (arg == "--segment" && hasValue) {
+      options.segment = argv[++i];
+    } else if (arg == "--particles" && hasValue) {
+      options.particles = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--species" && hasValue) {
+      options.species = std::atoi(argv[++i]);
+    } else if (arg == "--steps" && hasValue) {
+      options.steps = std::atoi(argv[++i]);
+    } else if (arg == "--report" && hasValue) {
+      options.reportEvery = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--size" && i + 2 < argc) {
+      options.width = std::strtof(argv[++i], nullptr);
+      options.height = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--dt" && hasValue) {
+      options.deltaTime = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--rebalance" && hasValue) {
+      options.rebalanceThreshold = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--rebalance-every" && hasValue) {
+      options.rebalanceEvery = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--traversal" && hasValue) {
+      const std::string mode = argv[++i];
+      if (mode != "tiles" && mode != "index") {
+        return false;
+      }
+      options.tiledTraversal = mode == "tiles";
+    } else if (arg == "--seed" && hasValue) {
+      options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  if (!options.endpoints.empty()) {
+    options.ranks = static_cast<int>(options.endpoints.size());
+  }
+  return options.transport == "shm" || options.transport == "tcp";
+}
+
+void printReport(int step, const ImbalanceReport &report, int repartitions) {
+  size_t total = 0;
+  for (const RankTiming &rank : report.ranks) {
+    total += rank.owned;
+  }
+  std::printf("step %d: %zu particles, compute max %.2f ms mean %.2f ms, imbalance %.2f, "
+              "%d repartitions\n",
+              step, total, report.maxComputeMs, report.meanComputeMs, report.imbalance,
+              repartitions);
+  for (size_t r = 0; r < report.ranks.size(); ++r) {
+    const RankTiming &rank = report.ranks[r];
+    std::printf("  rank %zu: step %.2f ms compute %.2f ms comm %.2f ms owned %u halo %u "
+                "migrated %u\n",
+                r, rank.stepMs, rank.computeMs, rank.commMs, rank.owned, rank.halo,
+                rank.migrated);
+  }
+  std::fflush(stdout);
+}
+
+int runRank(const Options &options, int rank) {
+  try {
+    std::unique_ptr<Transport> transport =
+        options.transport == "shm"
+            ? createSharedMemoryTransport(options.segment, rank, options.ranks)
+            : createSocketTransport(options.endpoints, rank);
+
+    DistributedWorld world(*transport, {options.width, options.height}, WorldParams{});
+    RebalanceSettings &rebalance = world.getRebalanceSettings();
+    rebalance.enabled = options.rebalanceThreshold > 0.0F;
+    rebalance.threshold = options.rebalanceThreshold;
+    rebalance.checkEvery = options.rebalanceEvery;
+    world.getWorld().setTiledTraversal(options.tiledTraversal);
+    world.seedRandom(options.particles, options.species, options.seed);
+
+    for (int step = 1; step <= options.steps; ++step) {
+      world.step(options.deltaTime);
+      if (step % options.reportEvery == 0 || step == options.steps) {
+        const ImbalanceReport report = world.gatherTimings();
+        if (rank == 0) {
+          printReport(step, report, world.getRepartitionCount());
+        }
+      }
+    }
+    transport->barrier();
+  } catch (const std::exception &e) {
+    std::cerr << "Rank " << rank << ": " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  // Separately started ranks must agree on the name; a local launch can pick a private one
+  if (options.segment.empty()) {
+    options.segment =
+        options.rank >= 0 ? "/particle-life" : "/particle-life-" + std::to_string(getpid());
+  }
+
+  if (options.rank >= 0) {
+    if (options.transport == "tcp" && options.endpoints.empty()) {
+      std::cerr << "--rank with tcp needs --endpoints\n";
+      return 1;
+    }
+    return runRank(options, options.rank);
+  }
+
+  // Local launch: every rank is a child of this process
+  if (options.transport == "tcp" && options.endpoints.empty()) {
+    for (int r = 0; r < options.ranks; ++r) {
+      options.endpoints.push_back("127.0.0.1:" + std::to_string(options.basePort + r));
+    }
+  }
+  // A segment left behind by a crashed run would hold stale ring counters
+  shm_unlink(options.segment.c_str());
+
+  std::vector<pid_t> children;
+  for (int r = 0; r < options.ranks; ++r) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      std::_Exit(runRank(options, r));
+    }
+    if (pid < 0) {
+      std::cerr << "fork failed\n";
+      return 1;
+    }
+    children.push_back(pid);
+  }
+
+  int failures = 0;
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
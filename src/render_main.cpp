@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "Common.h"
+#include "Graphics/ImageWriter.h"
+#include "Graphics/Simulation.h"
+#include "Graphics/SoftwareRasterizer.h"
+#include "Graphics/World.h"
+
+// Headless image output. Runs a 2D world and renders it on the CPU every few steps, as PNG files
+// or as raw rgb24 frames on stdout for a video encoder, e.g.
+//   particle_life_render --frames 600 --out - |
+//       ffmpeg -f rawvideo -pix_fmt rgb24 -s 1280x720 -r 60 -i - out.mp4
+
+namespace {
+
+struct Options {
+  size_t particles = 1000000;
+  int species = 6;
+  int frames = 1;
+  int stepsPerFrame = 1;
+  int warmup = 0;
+  uint32_t seed = 1;
+  float width = 8000.0F;
+  float height = 8000.0F;
+  float deltaTime = 0.05F;
+  float radius = 4.0F;
+  int imageWidth = WINDOW_WIDTH;
+  int imageHeight = WINDOW_HEIGHT;
+  std::string out = "frame_%04d.png";
+};
+
+void printUsage() {
+  std::cerr << "Usage: particle_life_render [options]\n"
+               "  --particles N       particle count (default 1000000)\n"
+               "  --species N         number of species\n"
+               "  --size W H          box size\n"
+               "  --image W H         image size in pixels (default 1280 720)\n"
+               "  --frames N          frames to write (default 1)\n"
+               "  --steps N           steps between frames (default 1)\n"
+               "  --warmup N          steps before the first frame\n"
+               "  --dt T              time step\n"
+               "  --radius R          particle radius as in the windowed app (default 4)\n"
+               "  --seed S            random seed\n"
+               "  --out PATTERN       PNG file names with one %d or %0Nd for the frame index\n"
+               "                      (%% for a literal %), or - for raw rgb24 on stdout\n";
+}
+
+// An --out pattern split around its frame index conversion
+struct FramePattern {
+  std::string prefix;
+  std::string suffix;
+  size_t width = 0; // zero padded to this many digits
+};
+
+// Accepts exactly one %d or %0Nd, so the pattern never reaches printf
+bool parseFramePattern(const std::string &pattern, FramePattern &frame) {
+  bool converted = false;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    std::string &part = converted ? frame.suffix : frame.prefix;
+    if (pattern[i] != '%') {
+      part += pattern[i];
+      continue;
+    }
+    if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+      part += '%';
+      ++i;
+      continue;
+    }
+    if (converted) {
+      return false;
+    }
+    size_t j = i + 1;
+    const auto isDigit = [&](size_t k) {
+      return k < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[k])) != 0;
+    };
+    // Zero flag and a width of up to two digits
+    if (j < pattern.size() && pattern[j] == '0') {
+      if (!isDigit(++j)) {
+        return false;
+      }
+      frame.width = pattern[j++] - '0';
+      if (isDigit(j)) {
+        frame.width = (frame.width * 10) + (pattern[j++] - '0');
+      }
+    }
+    if (j >= pattern.size() || pattern[j] != 'd') {
+      return false;
+    }
+    converted = true;
+    i = j;
+  }
+  return converted;
+}
+
+std::string framePath(const FramePattern &frame, int frameIndex) {
+  std::string digits = std::to_string(frameIndex);
+  if (digits.size() < frame.width) {
+    digits.insert(0, frame.width - digits.size(), '0');
+  }
+  return frame.prefix + digits + frame.suffix;
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--particles" && hasValue) {
+      options.particles = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--species" && hasValue) {
+      options.species = std::atoi(argv[++i]);
+    } else if (arg == "--size" && i + 2 < argc) {
+      options.width = std::strtof(argv[++i], nullptr);
+      options.height = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--image" && i + 2 < argc) {
+      options.imageWidth = std::max(1, std::atoi(argv[++i]));
+      options.imageHeight = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--frames" && hasValue) {
+      options.frames = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--steps" && hasValue) {
+      options.stepsPerFrame = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--warmup" && hasValue) {
+      options.warmup = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--dt" && hasValue) {
+      options.deltaTime = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--radius" && hasValue) {
+      options.radius = std::strtof(argv[++i], nullptr);
+    } else if (arg == "--seed" && hasValue) {
+      options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--out" && hasValue) {
+      options.out = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+float millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+  FramePattern pattern;
+  if (options.out != "-" && !parseFramePattern(options.out, pattern)) {
+    std::cerr << "--out needs exactly one %d or %0Nd for the frame index: " << options.out
+              << "\n";
+    return 1;
+  }
+
+  try {
+    World2D world;
+    world.setExtent({options.width, options.height});
+    world.spawnRandom(options.particles, options.species, options.seed);
+    world.randomizeInteractions(options.species, options.seed);
+    for (int step = 0; step < options.warmup; ++step) {
+      world.step(options.deltaTime);
+    }
+
+    // The whole box, widened to the image's aspect like the window's reference frame
+    SoftwareRasterizer rasterizer(options.imageWidth, options.imageHeight);
+    glm::vec2 frame(options.width, options.height);
+    const float aspect = static_cast<float>(options.imageWidth) / options.imageHeight;
+    if (frame.x / frame.y < aspect) {
+      frame.x = frame.y * aspect;
+    } else {
+      frame.y = frame.x / aspect;
+    }
+    rasterizer.setView(-0.5F * frame, 0.5F * frame);
+    rasterizer.setPalette(simulation::COLORS);
+    rasterizer.setBackground(glm::vec3(glBackgroundColour));
+
+    const bool raw = options.out == "-";
+    for (int frameIndex = 0; frameIndex < options.frames; ++frameIndex) {
+      const auto stepStart = std::chrono::steady_clock::now();
+      const int steps = frameIndex > 0 ? options.stepsPerFrame : 0;
+      for (int step = 0; step < steps; ++step) {
+        world.step(options.deltaTime);
+      }
+      const float stepMs = millisecondsSince(stepStart);
+
+      const auto renderStart = std::chrono::steady_clock::now();
+      rasterizer.render(world.getPositions(), world.getSpecies(), world.size(), options.radius);
+      const float renderMs = millisecondsSince(renderStart);
+
+      const auto writeStart = std::chrono::steady_clock::now();
+      if (raw) {
+        writeRawFrame(std::cout, rasterizer.getPixels().data(), options.imageWidth,
+                      options.imageHeight);
+      } else {
+        writePng(framePath(pattern, frameIndex), rasterizer.getPixels().data(), options.imageWidth,
+                 options.imageHeight);
+      }
+      std::fprintf(stderr, "frame %d: step %.2f ms, render %.2f ms, write %.2f ms\n", frameIndex,
+                   stepMs, renderMs, millisecondsSince(writeStart));
+    }
+    std::cout.flush();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
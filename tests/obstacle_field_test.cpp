@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "Graphics/ObstacleField.h"
+
+// Bitmaps are stored top row first while the world is y-up: a mask whose only solid pixel is in
+// its top-left corner must block the top-left of its rectangle and leave the bottom-left free,
+// and the drawn mesh must cover the same quarter the field treats as solid.
+int main() {
+  std::vector<uint8_t> mask(16, 0);
+  mask[0] = 1; // row 0, column 0
+
+  ObstacleField field;
+  field.addBitmap(mask, 4, 4, glm::vec2(-100.0F), glm::vec2(100.0F));
+  field.rasterize(2.0F, glm::vec2(-200.0F), glm::vec2(400.0F));
+
+  glm::vec2 gradient;
+  const float topLeft = field.sample(glm::vec2(-75.0F, 75.0F), gradient);
+  const float bottomLeft = field.sample(glm::vec2(-75.0F, -75.0F), gradient);
+  const float topRight = field.sample(glm::vec2(75.0F, 75.0F), gradient);
+
+  int failures = 0;
+  if (topLeft >= 0.0F) {
+    std::fprintf(stderr, "top-left pixel is not solid: distance %f\n", topLeft);
+    ++failures;
+  }
+  if (bottomLeft <= 0.0F) {
+    std::fprintf(stderr, "bitmap is flipped, bottom-left is solid: distance %f\n", bottomLeft);
+    ++failures;
+  }
+  if (topRight <= 0.0F) {
+    std::fprintf(stderr, "bitmap is mirrored, top-right is solid: distance %f\n", topRight);
+    ++failures;
+  }
+
+  // One solid pixel is one quad, which must span the pixel at [-100, -50] x [50, 100]
+  const std::vector<Vertex2D> &mesh = field.getMesh(glm::vec4(1.0F));
+  if (mesh.size() != 6) {
+    std::fprintf(stderr, "expected one quad for one pixel, got %zu vertices\n", mesh.size());
+    return 1;
+  }
+  glm::vec2 low(mesh[0].position);
+  glm::vec2 high(mesh[0].position);
+  for (const Vertex2D &vertex : mesh) {
+    low = glm::min(low, vertex.position);
+    high = glm::max(high, vertex.position);
+  }
+  if (low != glm::vec2(-100.0F, 50.0F) || high != glm::vec2(-50.0F, 100.0F)) {
+    std::fprintf(stderr, "mesh quad spans (%f, %f) to (%f, %f), not the solid pixel\n", low.x,
+                 low.y, high.x, high.y);
+    ++failures;
+  }
+  const float meshCentre = field.sample(0.5F * (low + high), gradient);
+  if (meshCentre >= 0.0F) {
+    std::fprintf(stderr, "mesh quad is drawn over free space: distance %f\n", meshCentre);
+    ++failures;
+  }
+  return failures == 0 ? 0 : 1;
+}